@@ -1,4 +1,6 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVDataConverter.h"
+#include "DSP/HCVGateLogic.h"
 
 /*
                                     ┌─────►
@@ -70,14 +72,16 @@ struct AnalogToDigital : HCVModule
 		NUM_LIGHTS
     };
 
-    dsp::SchmittTrigger clockTrigger;
+    HCVSchmittBank clockTriggers;
     dsp::SchmittTrigger modeTrigger;
     dsp::SchmittTrigger rectTrigger;
 
     int mode = 0;
     int rectMode = 0;
+    int bitDepth = 8;
 
-    float outs[8] = {};
+    //the last quantized word of each channel, held between sync pulses
+    simd::int32_4 words[4] = {};
 
 	AnalogToDigital()
 	{
@@ -102,14 +106,14 @@ struct AnalogToDigital : HCVModule
 
     void process(const ProcessArgs &args) override;
 
-    void processUni8(float _input);
-    void processBiOff(float _input);
-    void processBiSig(float _input);
+    template <int CHANNELS>
+    void processChannels(const ProcessArgs &args, int _channels);
 
     void onReset() override
     {
         mode = 0;
         rectMode = 0;
+        bitDepth = 8;
 	}
     void onRandomize() override
     {
@@ -122,6 +126,7 @@ struct AnalogToDigital : HCVModule
 		json_t *rootJ = json_object();
         json_object_set_new(rootJ, "mode", json_integer(mode));
         json_object_set_new(rootJ, "rectMode", json_integer(rectMode));
+        json_object_set_new(rootJ, "bitDepth", json_integer(bitDepth));
 		return rootJ;
 	}
     void dataFromJson(json_t *rootJ) override
@@ -133,6 +138,10 @@ struct AnalogToDigital : HCVModule
         json_t *rectModeJ = json_object_get(rootJ, "rectMode");
         if (rectModeJ)
             rectMode = json_integer_value(rectModeJ);
+
+        json_t *bitDepthJ = json_object_get(rootJ, "bitDepth");
+        if (bitDepthJ)
+            bitDepth = clamp(int(json_integer_value(bitDepthJ)), 1, HCVDataConverter::MAX_BITS);
 	}
 
 	// For more advanced Module features, read Rack's engine.hpp header file
@@ -155,82 +164,77 @@ void AnalogToDigital::process(const ProcessArgs &args)
     lights[RECT_HALF_LIGHT].setBrightness(rectMode == 1 ? 1.0f : 0.0f);
     lights[RECT_FULL_LIGHT].setBrightness(rectMode == 2 ? 1.0f : 0.0f);
 
+    processWithChannelCount(this, args, std::max(1, inputs[MAIN_INPUT].getChannels()));
+}
+
+template <int CHANNELS>
+void AnalogToDigital::processChannels(const ProcessArgs &args, int _channels)
+{
+    const int channels = CHANNELS > 0 ? CHANNELS : _channels;
+    const float scale = params[SCALE_PARAM].getValue();
+    const float offset = params[OFFSET_PARAM].getValue();
+
+    //a mono sync input clocks every channel
     const bool syncModeEnabled = inputs[SYNC_INPUT].isConnected();
-    const bool readyForProcess = (!syncModeEnabled || (syncModeEnabled && clockTrigger.process(inputs[SYNC_INPUT].getVoltage())));
+    const uint32_t readyForProcess = syncModeEnabled ? clockTriggers.process(inputs[SYNC_INPUT], channels) : HCVGateLogic::channelMask(channels);
 
-    if(readyForProcess)
+    for (int c = 0; c < channels; c += 4)
     {
-        float input = inputs[MAIN_INPUT].getVoltage();
-        input *= params[SCALE_PARAM].getValue();
-        input += params[OFFSET_PARAM].getValue();
-        if (rectMode == 1) input = input > 0.0f? input : 0.0f;
-        else if (rectMode == 2) input = std::abs(input);
-
-        if(mode == 0) processUni8(input);
-        else if (mode == 1) processBiOff(input);
-        else if (mode == 2) processBiSig(input);
+        const int vectorIndex = c/4;
+        if (((readyForProcess >> c) & 0xF) == 0) continue;
+
+        simd::float_4 input = inputs[MAIN_INPUT].getPolyVoltageSimd<simd::float_4>(c);
+        input = input * scale + offset;
+        if (rectMode == 1) input = simd::fmax(input, 0.0f);
+        else if (rectMode == 2) input = simd::fabs(input);
+
+        const simd::int32_4 encoded = HCVDataConverter::encode(input, mode, bitDepth);
+        const simd::float_4 clocked = HCVGateLogic::bitsToLanes(readyForProcess >> c);
+        words[vectorIndex] = simd::ifelse(simd::int32_4::cast(clocked), encoded, words[vectorIndex]);
     }
 
+    //bit jacks carry the low eight bits of every channel. Bits above the depth stay at 0V.
     for(int i = 0; i < 8; i++)
     {
-        outputs[OUT1_OUTPUT + i].setVoltage(outs[i]);
-        outputs[POLY_OUTPUT].setVoltage(outs[i], i);
-        lights[OUT1_LIGHT + i].value = outs[i];
+        outputs[OUT1_OUTPUT + i].setChannels(channels);
+        for (int c = 0; c < channels; c += 4)
+        {
+            const simd::float_4 bit = simd::float_4::cast(HCVDataConverter::getBit(words[c/4], i));
+            outputs[OUT1_OUTPUT + i].setVoltageSimd(simd::ifelse(bit, HCV_GATE_MAG, 0.0f), c);
+        }
+        lights[OUT1_LIGHT + i].value = outputs[OUT1_OUTPUT + i].getVoltage(0);
     }
 
-    outputs[POLY_OUTPUT].setChannels(8);
+    //the poly jack carries every bit of the first channel, one bit per channel
+    outputs[POLY_OUTPUT].setChannels(bitDepth);
+    for (int i = 0; i < bitDepth; i++)
+    {
+        outputs[POLY_OUTPUT].setVoltage(((words[0][0] >> i) & 1) ? HCV_GATE_MAG : 0.0f, i);
+    }
 }
 
-void AnalogToDigital::processUni8(float _input)
-{
-    _input = clamp(_input, 0.0f, 1.0f);
-    uint8_t bits = round(_input * 255);
-
-    outs[0] = (bits & 0b00000001) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[1] = (bits & 0b00000010) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[2] = (bits & 0b00000100) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[3] = (bits & 0b00001000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[4] = (bits & 0b00010000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[5] = (bits & 0b00100000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[6] = (bits & 0b01000000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[7] = (bits & 0b10000000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-}
 
-void AnalogToDigital::processBiOff(float _input)
+struct AnalogToDigitalWidget : HCVModuleWidget
 {
-    _input = clamp(_input, -1.0f, 1.0f);
-    _input = (_input + 1.0f) * 0.5f;
-    uint8_t bits = round(_input * 255);
-
-    outs[0] = (bits & 0b00000001) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[1] = (bits & 0b00000010) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[2] = (bits & 0b00000100) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[3] = (bits & 0b00001000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[4] = (bits & 0b00010000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[5] = (bits & 0b00100000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[6] = (bits & 0b01000000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[7] = (bits & 0b10000000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-}
+    AnalogToDigitalWidget(AnalogToDigital *module);
 
-void AnalogToDigital::processBiSig(float _input)
-{
-    outs[7] = _input < 0.0f ? HCV_GATE_MAG : 0.0f;
-
-    _input = clamp(_input, -1.0f, 1.0f);
-    _input = std::abs(_input);
-    uint8_t bits = round(_input * 127);
-
-    outs[0] = (bits & 0b00000001) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[1] = (bits & 0b00000010) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[2] = (bits & 0b00000100) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[3] = (bits & 0b00001000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[4] = (bits & 0b00010000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[5] = (bits & 0b00100000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-    outs[6] = (bits & 0b01000000) > 0.0f ? HCV_GATE_MAG : 0.0f;
-}
+    void appendContextMenu(Menu *menu) override
+    {
+        AnalogToDigital *converter = dynamic_cast<AnalogToDigital*>(module);
+        assert(converter);
 
+        std::vector<std::string> depthLabels;
+        for (int i = 1; i <= HCVDataConverter::MAX_BITS; i++)
+        {
+            depthLabels.push_back(std::to_string(i) + " bits");
+        }
 
-struct AnalogToDigitalWidget : HCVModuleWidget { AnalogToDigitalWidget(AnalogToDigital *module); };
+        menu->addChild(new MenuSeparator());
+        menu->addChild(createIndexSubmenuItem("Bit Depth", depthLabels,
+            [=]() { return size_t(converter->bitDepth - 1); },
+            [=](size_t index) { converter->bitDepth = int(index) + 1; }));
+    }
+};
 
 AnalogToDigitalWidget::AnalogToDigitalWidget(AnalogToDigital *module)
 {
@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVGateLogic.h"
 
 struct BinaryGate : HCVModule
 {
@@ -45,8 +46,9 @@ struct BinaryGate : HCVModule
 
 	void process(const ProcessArgs &args) override;
 
-    bool gateState[16] = {};
-    dsp::SchmittTrigger onTrigger[16], offTrigger[16], toggleTrigger[16];
+    // Bitmasks for polyphonic support, bit c holds channel c
+    uint32_t gateState = 0;
+    HCVSchmittBank onTrigger, offTrigger, toggleTrigger;
 
 	// For more advanced Module features, read Rack's engine.hpp header file
 	// - dataToJson, dataFromJson: serialization of internal data
@@ -60,40 +62,36 @@ void BinaryGate::process(const ProcessArgs &args)
     // Determine the number of channels based on connected inputs
     int channels = setupPolyphonyForAllOutputs();
 
-    // Process each channel
-    for (int c = 0; c < channels; c++)
-    {
-        // Get input voltages for this channel (0V if channel doesn't exist)
-        float onVoltage = inputs[ON_INPUT].getPolyVoltage(c);
-        float offVoltage = inputs[OFF_INPUT].getPolyVoltage(c);
-        float toggleVoltage = inputs[TOGGLE_INPUT].getPolyVoltage(c);
+    // For buttons, only apply to channel 0 (monophonic control)
+    const simd::float_4 onButton = simd::float_4(params[ON_PARAM].getValue(), 0.0f, 0.0f, 0.0f);
+    const simd::float_4 offButton = simd::float_4(params[OFF_PARAM].getValue(), 0.0f, 0.0f, 0.0f);
+    const simd::float_4 toggleButton = simd::float_4(params[TOGGLE_PARAM].getValue(), 0.0f, 0.0f, 0.0f);
 
-        // For buttons, only apply to channel 0 (monophonic control)
-        float onButtonVoltage = (c == 0) ? params[ON_PARAM].getValue() : 0.0f;
-        float offButtonVoltage = (c == 0) ? params[OFF_PARAM].getValue() : 0.0f;
-        float toggleButtonVoltage = (c == 0) ? params[TOGGLE_PARAM].getValue() : 0.0f;
+    uint32_t on = 0, off = 0, toggled = 0;
+    for (int c = 0; c < channels; c += 4)
+    {
+        simd::float_4 onVoltage = inputs[ON_INPUT].getPolyVoltageSimd<simd::float_4>(c);
+        simd::float_4 offVoltage = inputs[OFF_INPUT].getPolyVoltageSimd<simd::float_4>(c);
+        simd::float_4 toggleVoltage = inputs[TOGGLE_INPUT].getPolyVoltageSimd<simd::float_4>(c);
 
-        if(onTrigger[c].process(onVoltage + onButtonVoltage))
+        if(c == 0)
         {
-            gateState[c] = true;
+            onVoltage += onButton;
+            offVoltage += offButton;
+            toggleVoltage += toggleButton;
         }
 
-        if(offTrigger[c].process(offVoltage + offButtonVoltage))
-        {
-            gateState[c] = false;
-        }
+        on |= onTrigger.process(c, onVoltage, channels);
+        off |= offTrigger.process(c, offVoltage, channels);
+        toggled |= toggleTrigger.process(c, toggleVoltage, channels);
+    }
 
-        if(toggleTrigger[c].process(toggleVoltage + toggleButtonVoltage))
-        {
-            gateState[c] = !gateState[c];
-        }
+    gateState = ((gateState | on) & ~off) ^ toggled;
 
-        // Set output voltage for this channel
-        outputs[GATE_OUTPUT].setVoltage(gateState[c] ? HCV_GATE_MAG : 0.0f, c);
-    }
+    HCVGateLogic::setGates(outputs[GATE_OUTPUT], gateState, channels, HCV_GATE_MAG);
 
     // Light shows the state of channel 0
-    lights[GATE_LIGHT].setBrightness(gateState[0] ? 1.0f : 0.0f);
+    lights[GATE_LIGHT].setBrightness((gateState & 1) ? 1.0f : 0.0f);
 }
 
 struct BinaryGateWidget : HCVModuleWidget { BinaryGateWidget(BinaryGate *module); };
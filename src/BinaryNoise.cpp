@@ -1,4 +1,6 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVGateLogic.h"
+#include "DSP/HCVRandom.h"
 #include "DSP/HCVSampleRate.h"
 
 struct BinaryNoise : HCVModule
@@ -57,8 +59,11 @@ struct BinaryNoise : HCVModule
 	void process(const ProcessArgs &args) override;
 
     // Arrays for polyphonic support
-    float lastOut[16] = {};
-    rack::dsp::SchmittTrigger clockTrigger[16];
+    alignas(16) float lastOut[16] = {};
+    HCVSchmittBank clockTrigger;
+
+    // One random draw per four channels
+    HCVRandom4 randomGens[4];
 
     HCVSampleRate sRate[16];
     HCVSRateInterpolator slew[16];
@@ -75,28 +80,40 @@ void BinaryNoise::process(const ProcessArgs &args)
     // Determine the number of channels based on connected inputs
     int channels = setupPolyphonyForAllOutputs();
 
-    // Process each channel
+    const bool clockConnected = inputs[CLOCK_INPUT].isConnected();
+    const uint32_t clocks = clockConnected ? clockTrigger.process(inputs[CLOCK_INPUT], channels) : 0;
+
+    uint32_t readyChannels = 0;
     for (int c = 0; c < channels; c++)
     {
         double sr = getSampleRateParameter(SRATE_PARAM, SRATE_INPUT, SRATE_SCALE_PARAM, RANGE_PARAM, c);
         sRate[c].setSampleRateFactor(sr);
 
         bool isReady = sRate[c].readyForNextSample();
-        if(inputs[CLOCK_INPUT].isConnected()) 
-        {
-            isReady = clockTrigger[c].process(inputs[CLOCK_INPUT].getPolyVoltage(c));
-        }
+        if(clockConnected) isReady = (clocks >> c) & 1;
 
-        if(isReady)
-        {
-            float prob = getNormalizedModulatedValue(PROB_PARAM, PROB_INPUT, PROB_SCALE_PARAM, c);
-            bool on = random::uniform() < prob;
-            float offset = (1.0f - params[POLARITY_PARAM].getValue()) * -5.0f;
+        readyChannels |= uint32_t(isReady) << c;
+    }
 
-            lastOut[c] = (on ? HCV_GATE_MAG + offset : offset);
+    // New values for the ready channels, four at a time
+    const float offset = (1.0f - params[POLARITY_PARAM].getValue()) * -5.0f;
+    for (int c = 0; c < channels; c += 4)
+    {
+        const uint32_t readyLanes = (readyChannels >> c) & 0xF;
+        if(!readyLanes) continue;
+
+        simd::float_4 prob = params[PROB_PARAM].getValue() + (inputs[PROB_INPUT].getPolyVoltageSimd<simd::float_4>(c) * params[PROB_SCALE_PARAM].getValue());
+        prob = simd::clamp(prob * 0.1f + 0.5f, 0.0f, 1.0f);
+
+        const simd::float_4 on = randomGens[c/4].nextFloat() < prob;
+        const simd::float_4 newOut = simd::ifelse(on, HCV_GATE_MAG + offset, offset);
+        simd::float_4 outs = simd::ifelse(HCVGateLogic::bitsToLanes(readyLanes), newOut, simd::float_4::load(lastOut + c));
+        outs.store(lastOut + c);
+    }
 
-            slew[c].setTargetValue(lastOut[c]);
-        }   
+    for (int c = 0; c < channels; c++)
+    {
+        if((readyChannels >> c) & 1) slew[c].setTargetValue(lastOut[c]);
 
         if(params[SLEW_PARAM].getValue() == 1.0f)
         {
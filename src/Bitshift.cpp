@@ -1,4 +1,6 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVBitshift.h"
+#include "DSP/HCVOversampler.h"
 
 /*                                                               
  ┌──────────────────────────────────────────────────────────────┐
@@ -64,6 +66,40 @@ struct Bitshift : HCVModule
 					intIns[4] = {0, 0, 0, 0},
 					shiftedIns[4] = {0, 0, 0, 0};
 
+	int shiftMode = HCVBitshift::ARITHMETIC_SHIFT;
+	int bitDepth = 32;
+
+	HCVOversampler4 oversamplers[4];
+	int oversampling = 0;
+
+	void onReset() override
+	{
+		shiftMode = HCVBitshift::ARITHMETIC_SHIFT;
+		bitDepth = 32;
+		oversampling = 0;
+	}
+
+	json_t *dataToJson() override
+	{
+		json_t *rootJ = json_object();
+		json_object_set_new(rootJ, "shiftMode", json_integer(shiftMode));
+		json_object_set_new(rootJ, "bitDepth", json_integer(bitDepth));
+		json_object_set_new(rootJ, "oversampling", json_integer(oversampling));
+		return rootJ;
+	}
+
+	void dataFromJson(json_t *rootJ) override
+	{
+		json_t *modeJ = json_object_get(rootJ, "shiftMode");
+		if (modeJ) shiftMode = clamp(int(json_integer_value(modeJ)), 0, HCVBitshift::NUM_SHIFT_MODES - 1);
+
+		json_t *depthJ = json_object_get(rootJ, "bitDepth");
+		if (depthJ) bitDepth = clamp(int(json_integer_value(depthJ)), 1, 32);
+
+		json_t *oversamplingJ = json_object_get(rootJ, "oversampling");
+		if (oversamplingJ) oversampling = clamp(int(json_integer_value(oversamplingJ)), 0, HCVOversampler4::MAX_STAGES);
+	}
+
 	// For more advanced Module features, read Rack's engine.hpp header file
 	// - dataToJson, dataFromJson: serialization of internal data
 	// - onSampleRateChange: event triggered by a change of sample rate
@@ -87,6 +123,8 @@ void Bitshift::process(const ProcessArgs &args)
 	const float amount = params[AMOUNT_PARAM].getValue();
 	const float scale = params[SCALE_PARAM].getValue();
 
+	const simd::int32_4 depthMask = HCVBitshift::getDepthMask(bitDepth);
+
 	int channels = getMaxInputPolyphony();
 	outputs[MAIN_OUTPUT].setChannels(channels);
 
@@ -101,30 +139,51 @@ void Bitshift::process(const ProcessArgs &args)
 		shifts[vectorIndex] = clamp(shifts[vectorIndex], -5.0f, 5.0f) * 0.2f * 31.0f;
 
 		intShifts[vectorIndex] = round(shifts[vectorIndex]);
-		intIns[vectorIndex] = round(ins[vectorIndex] * 2147483647.0f);
 
-		for (int i = 0; i < 4; i++)
+		//the upsampling filter can overshoot, so the input is clamped again before it becomes an integer
+		oversamplers[vectorIndex].setStages(oversampling);
+		outs[vectorIndex] = oversamplers[vectorIndex].process(ins[vectorIndex], [&](simd::float_4 _x)
 		{
-			if (intShifts[vectorIndex][i] > 0)
-			{
-				shiftedIns[vectorIndex][i] = intIns[vectorIndex][i] >> intShifts[vectorIndex][i];
-			}
-			else
-			{
-				intShifts[vectorIndex][i] *= -1;
-				shiftedIns[vectorIndex][i] = intIns[vectorIndex][i] << intShifts[vectorIndex][i];
-			}
-		}
-
-		outs[vectorIndex] = shiftedIns[vectorIndex]/2147483647.0f;
-		outs[vectorIndex] = clamp(outs[vectorIndex], -1.0f, 1.0f) * upscale;
+			intIns[vectorIndex] = round(clamp(_x, -1.0f, 1.0f) * 2147483647.0f);
+			shiftedIns[vectorIndex] = HCVBitshift::process(intIns[vectorIndex], intShifts[vectorIndex], shiftMode) & depthMask;
+			return clamp(shiftedIns[vectorIndex]/2147483647.0f, -1.0f, 1.0f);
+		});
+		outs[vectorIndex] *= upscale;
 
 		outs[vectorIndex].store(outputs[MAIN_OUTPUT].getVoltages(c));
 	}
 }
 
 
-struct BitshiftWidget : HCVModuleWidget { BitshiftWidget(Bitshift *module); };
+struct BitshiftWidget : HCVModuleWidget
+{
+	BitshiftWidget(Bitshift *module);
+
+	void appendContextMenu(Menu *menu) override
+	{
+		Bitshift *bitshift = dynamic_cast<Bitshift*>(module);
+		assert(bitshift);
+
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createIndexSubmenuItem("Shift Mode", {"Arithmetic", "Logical", "Rotate"},
+			[=]() { return size_t(bitshift->shiftMode); },
+			[=](size_t index) { bitshift->shiftMode = int(index); }));
+
+		std::vector<std::string> depthLabels;
+		for (int i = 1; i <= 32; i++)
+		{
+			depthLabels.push_back(std::to_string(i) + " bits");
+		}
+
+		menu->addChild(createIndexSubmenuItem("Bit Depth", depthLabels,
+			[=]() { return size_t(bitshift->bitDepth - 1); },
+			[=](size_t index) { bitshift->bitDepth = int(index) + 1; }));
+
+		menu->addChild(createIndexSubmenuItem("Oversampling", HCVOversampler4::getLabels(),
+			[=]() { return size_t(bitshift->oversampling); },
+			[=](size_t index) { bitshift->oversampling = int(index); }));
+	}
+};
 
 BitshiftWidget::BitshiftWidget(Bitshift *module)
 {
@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVGateLogic.h"
 
 struct Boolean3 : HCVModule
 {
@@ -38,12 +39,8 @@ struct Boolean3 : HCVModule
         NUM_LIGHTS
 	};
 
-    // Arrays for polyphonic support
-    HysteresisGate ins[16][3];
-    bool inA[16] = {};
-    bool inB[16] = {};
-    bool inC[16] = {};
-    float outs[16][6] = {};
+    // Bitmasks for polyphonic support, bit c holds channel c
+    HCVHysteresisBank ins[3];
 
 	Boolean3()
 	{
@@ -74,54 +71,47 @@ void Boolean3::process(const ProcessArgs &args)
 {
     // Determine the number of channels based on connected inputs
     int channels = setupPolyphonyForAllOutputs();
+    const uint32_t allChannels = HCVGateLogic::channelMask(channels);
 
-    // Process each channel
-    for (int c = 0; c < channels; c++)
+    const uint32_t inA = ins[0].process(inputs[INA_INPUT], channels);
+    const uint32_t inB = ins[1].process(inputs[INB_INPUT], channels);
+    const uint32_t inC = ins[2].process(inputs[INC_INPUT], channels);
+
+    uint32_t orGates, andGates, xorGates;
+    if(inputs[INC_INPUT].isConnected())
+    {
+        // 3-input logic operations
+        orGates = inA | inB | inC;
+        andGates = inA & inB & inC;
+        xorGates = (~inA & (inB ^ inC)) | (inA & ~(inB | inC));
+    }
+    else
     {
-        inA[c] = ins[c][0].process(inputs[INA_INPUT].getPolyVoltage(c));
-        inB[c] = ins[c][1].process(inputs[INB_INPUT].getPolyVoltage(c));
-        inC[c] = ins[c][2].process(inputs[INC_INPUT].getPolyVoltage(c));
+        // 2-input logic operations (when C is not connected)
+        orGates = inA | inB;
+        andGates = inA & inB;
+        xorGates = inA ^ inB;
+    }
 
-        if(inputs[INC_INPUT].isConnected())
-        {
-            // 3-input logic operations
-            outs[c][0] = ((inA[c] || inB[c]) || inC[c]) ? HCV_GATE_MAG : 0.0f;  // OR
-            outs[c][1] = ((inA[c] && inB[c]) && inC[c]) ? HCV_GATE_MAG : 0.0f;  // AND
-            outs[c][2] = (!inA[c] && (inB[c] ^ inC[c])) || (inA[c] && !(inB[c] || inC[c])) ? HCV_GATE_MAG : 0.0f;  // XOR
-            outs[c][3] = HCV_GATE_MAG - outs[c][0];  // NOR
-            outs[c][4] = HCV_GATE_MAG - outs[c][1];  // NAND
-            outs[c][5] = HCV_GATE_MAG - outs[c][2];  // XNOR
-        }
-        else
+    const uint32_t outs[6] = {orGates, andGates, xorGates, ~orGates & allChannels, ~andGates & allChannels, ~xorGates & allChannels};
+    for (int i = 0; i < 6; i++)
+    {
+        // Unpatched outputs and their lights stay dark
+        if(!isOutputConnected(OR_OUTPUT + i))
         {
-            // 2-input logic operations (when C is not connected)
-            outs[c][0] = (inA[c] || inB[c]) ? HCV_GATE_MAG : 0.0f;  // OR
-            outs[c][1] = (inA[c] && inB[c]) ? HCV_GATE_MAG : 0.0f;  // AND
-            outs[c][2] = (inA[c] != inB[c]) ? HCV_GATE_MAG : 0.0f;  // XOR
-            outs[c][3] = HCV_GATE_MAG - outs[c][0];  // NOR
-            outs[c][4] = HCV_GATE_MAG - outs[c][1];  // NAND
-            outs[c][5] = HCV_GATE_MAG - outs[c][2];  // XNOR
+            lights[OR_LIGHT + i].value = 0.0f;
+            continue;
         }
 
-        outputs[OR_OUTPUT].setVoltage(outs[c][0], c);
-        outputs[AND_OUTPUT].setVoltage(outs[c][1], c);
-        outputs[XOR_OUTPUT].setVoltage(outs[c][2], c);
-        outputs[NOR_OUTPUT].setVoltage(outs[c][3], c);
-        outputs[NAND_OUTPUT].setVoltage(outs[c][4], c);
-        outputs[XNOR_OUTPUT].setVoltage(outs[c][5], c);
+        HCVGateLogic::setGates(outputs[OR_OUTPUT + i], outs[i], channels, HCV_GATE_MAG);
+
+        // Lights show the state of channel 0
+        lights[OR_LIGHT + i].value = (outs[i] & 1) ? HCV_GATE_MAG : 0.0f;
     }
 
-    // Lights show the state of channel 0
-    lights[INA_LIGHT].value = inA[0] ? HCV_GATE_MAG : 0.0f;
-    lights[INB_LIGHT].value = inB[0] ? HCV_GATE_MAG : 0.0f;
-    lights[INC_LIGHT].value = inC[0] ? HCV_GATE_MAG : 0.0f;
-
-    lights[OR_LIGHT].value = outs[0][0];
-    lights[AND_LIGHT].value = outs[0][1];
-    lights[XOR_LIGHT].value = outs[0][2];
-    lights[NOR_LIGHT].value = outs[0][3];
-    lights[NAND_LIGHT].value = outs[0][4];
-    lights[XNOR_LIGHT].value = outs[0][5];
+    lights[INA_LIGHT].value = (inA & 1) ? HCV_GATE_MAG : 0.0f;
+    lights[INB_LIGHT].value = (inB & 1) ? HCV_GATE_MAG : 0.0f;
+    lights[INC_LIGHT].value = (inC & 1) ? HCV_GATE_MAG : 0.0f;
 }
 
 struct Boolean3Widget : HCVModuleWidget { Boolean3Widget(Boolean3 *module); };
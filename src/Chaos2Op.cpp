@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVGateLogic.h"
 #include "DSP/HCVChaos.h" 
 #include "DSP/HCVDCFilter.h"
 #include "DSP/HCVSampleRate.h"
@@ -88,7 +89,7 @@ struct Chaos2Op : HCVModule
     int mode[16] = {};
     float chaosAmountA[16] = {}, chaosAmountB[16] = {};
 
-    rack::dsp::SchmittTrigger clockTrigger[16], reseedTrigger[16];
+    HCVSchmittBank clockTrigger, reseedTrigger;
 
     HCVSampleRate sRate[16];
     HCVSRateInterpolator slewX[16], slewY[16];
@@ -185,6 +186,10 @@ void Chaos2Op::process(const ProcessArgs &args)
     // Determine the number of channels based on connected inputs
     int channels = setupPolyphonyForAllOutputs();
 
+    const bool clockConnected = inputs[CLOCK_INPUT].isConnected();
+    const uint32_t clocks = clockConnected ? clockTrigger.process(inputs[CLOCK_INPUT], channels) : 0;
+    const uint32_t reseeds = reseedTrigger.process(inputs[RESEED_INPUT], channels, params[RESEED_PARAM].getValue());
+
     // Process each channel
     for (int c = 0; c < channels; c++)
     {
@@ -192,9 +197,9 @@ void Chaos2Op::process(const ProcessArgs &args)
         sRate[c].setSampleRateFactor(sr);
 
         bool isReady = sRate[c].readyForNextSample();
-        if(inputs[CLOCK_INPUT].isConnected()) isReady = clockTrigger[c].process(inputs[CLOCK_INPUT].getPolyVoltage(c));
+        if(clockConnected) isReady = (clocks >> c) & 1;
 
-        if(reseedTrigger[c].process(inputs[RESEED_INPUT].getPolyVoltage(c) + (c == 0 ? params[RESEED_PARAM].getValue() : 0.0f)))
+        if((reseeds >> c) & 1)
         {
             resetChaos(c);
         }
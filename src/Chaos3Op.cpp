@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVGateLogic.h"
 #include "DSP/HCVChaos.h" 
 #include "DSP/HCVDCFilter.h"
 #include "DSP/HCVSampleRate.h"
@@ -88,7 +89,7 @@ struct Chaos3Op : HCVModule
     // Single boolean for all channels (front-panel switch)
     bool quadraticMode = false;
 
-    rack::dsp::SchmittTrigger clockTrigger[16], reseedTrigger[16];
+    HCVSchmittBank clockTrigger, reseedTrigger;
 
     HCVSampleRate sRate[16];
     HCVSRateInterpolator slew[16];
@@ -143,6 +144,10 @@ void Chaos3Op::process(const ProcessArgs &args)
     // Mode is global for all channels (front-panel switch)
     quadraticMode = params[MODE_PARAM].getValue();
 
+    const bool clockConnected = inputs[CLOCK_INPUT].isConnected();
+    const uint32_t clocks = clockConnected ? clockTrigger.process(inputs[CLOCK_INPUT], channels) : 0;
+    const uint32_t reseeds = reseedTrigger.process(inputs[RESEED_INPUT], channels, params[RESEED_PARAM].getValue());
+
     // Process each channel
     for (int c = 0; c < channels; c++)
     {
@@ -150,9 +155,9 @@ void Chaos3Op::process(const ProcessArgs &args)
         sRate[c].setSampleRateFactor(sr);
 
         bool isReady = sRate[c].readyForNextSample();
-        if(inputs[CLOCK_INPUT].isConnected()) isReady = clockTrigger[c].process(inputs[CLOCK_INPUT].getPolyVoltage(c));
+        if(clockConnected) isReady = (clocks >> c) & 1;
 
-        if(reseedTrigger[c].process(inputs[RESEED_INPUT].getPolyVoltage(c) + (c == 0 ? params[RESEED_PARAM].getValue() : 0.0f)))
+        if((reseeds >> c) & 1)
         {
             resetChaos(c);
         }
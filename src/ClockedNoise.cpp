@@ -1,9 +1,10 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVGateLogic.h"
 #include "DSP/HCVRandom.h" 
+#include "DSP/HCVColoredNoise.h"
 #include "DSP/HCVDCFilter.h"
 #include "DSP/HCVSampleRate.h"
 #include "DSP/HCVShiftRegister.h"
-#include "Gamma/Noise.h"
 
 struct ClockedNoise : HCVModule
 {
@@ -70,26 +71,60 @@ struct ClockedNoise : HCVModule
 
 	void process(const ProcessArgs &args) override;
 
+    enum NoiseModes
+    {
+        WHITE_MODE,
+        LFSR_MODE,
+        GRAY_MODE,
+        PINK_MODE,
+        BROWN_MODE,
+        GAUSSIAN_MODE,
+        NUM_MODES
+    };
+
     // Arrays for polyphonic support
-    float outVal[16] = {};
+    alignas(16) float outVal[16] = {};
+    alignas(16) float fluxNoise[16] = {};
     int mode[16] = {};
-    float fluxNoise[16] = {};
 
-    rack::dsp::SchmittTrigger clockTrigger[16];
+    HCVSchmittBank clockTrigger;
 
     HCVSampleRate sRate[16];
     HCVSRateInterpolator slew[16];
     HCVDCFilterT<float> dcFilter[16];
 
-    // Per-channel noise generators
-    HCVRandom randGen[16];
-    gam::NoiseWhite<> whiteNoise[16];
-    gam::NoisePink<> pinkNoise[16];
-    gam::NoiseBrown<> brownNoise[16];
-    HCVLFSRNoise lfsrNoise[16];
-    HCVGrayNoise grayNoise[16];
+    // Noise generators, four channels each
+    HCVRandom4 fluxGens[4];
+    HCVWhiteNoise4 whiteNoise[4];
+    HCVLFSRNoise4 lfsrNoise[4];
+    HCVGrayNoise4 grayNoise[4];
+    HCVPinkNoise4 pinkNoise[4];
+    HCVBrownNoise4 brownNoise[4];
+    HCVGaussianNoise4 gaussianNoise[4];
+
+    // Set from the menu and patch load, applied to the generators at the top of process()
+    int lfsrTaps = HCVLFSRNoise4::DEFAULT_TAPS;
+    int appliedLFSRTaps = HCVLFSRNoise4::DEFAULT_TAPS;
+
+    simd::float_4 renderNoise(int _mode, int _block, simd::float_4 _lanes);
+
+    void setLFSRTaps(int _index)
+    {
+        lfsrTaps = clamp(_index, 0, HCVLFSRNoise4::NUM_TAPS - 1);
+    }
 
-    void renderNoise(int channel);
+    json_t *dataToJson() override
+    {
+		json_t *rootJ = json_object();
+        json_object_set_new(rootJ, "lfsrTaps", json_integer(lfsrTaps));
+		return rootJ;
+	}
+
+    void dataFromJson(json_t *rootJ) override
+    {
+		json_t *tapsJ = json_object_get(rootJ, "lfsrTaps");
+		if (tapsJ) setLFSRTaps(json_integer_value(tapsJ));
+	}
 
     // For more advanced Module features, read Rack's engine.hpp header file
     // - dataToJson, dataFromJson: serialization of internal data
@@ -97,37 +132,31 @@ struct ClockedNoise : HCVModule
     // - reset, randomize: implements special behavior when user clicks these from the context menu
 };
 
-void ClockedNoise::renderNoise(int channel)
+//one noise color for one four-channel block
+simd::float_4 ClockedNoise::renderNoise(int _mode, int _block, simd::float_4 _lanes)
 {
-    switch(mode[channel])
+    switch(_mode)
     {
-        case 0: //white
-            outVal[channel] = whiteNoise[channel]();
-            break;
-        
-        case 1: //lfsr
-            outVal[channel] = lfsrNoise[channel]();
-            break;
-            
-        case 2: //gray
-            outVal[channel] = grayNoise[channel]();
-            break;
-            
-        case 3: //pink
-            outVal[channel] = pinkNoise[channel]() * 2.0;
-            break;
-            
-        case 4: //brown
-            outVal[channel] = brownNoise[channel]();
-            break;
-            
-        case 5: //gaussian
-            outVal[channel] = randGen[channel].nextGaussian();
-            break;
-            
+        case WHITE_MODE:
+            return whiteNoise[_block].process(_lanes);
+
+        case LFSR_MODE:
+            return lfsrNoise[_block].process(_lanes);
+
+        case GRAY_MODE:
+            return grayNoise[_block].process(_lanes);
+
+        case PINK_MODE:
+            return pinkNoise[_block].process(_lanes);
+
+        case BROWN_MODE:
+            return brownNoise[_block].process(_lanes);
+
+        case GAUSSIAN_MODE:
+            return gaussianNoise[_block].process(_lanes);
+
         default:
-            outVal[channel] = 0.0f;
-            break;
+            return 0.0f;
     }
 }
 
@@ -135,44 +164,78 @@ void ClockedNoise::process(const ProcessArgs &args)
 {
     // Determine the number of channels based on connected inputs
     int channels = setupPolyphonyForAllOutputs();
+
+    if(lfsrTaps != appliedLFSRTaps)
+    {
+        appliedLFSRTaps = lfsrTaps;
+        for (int i = 0; i < 4; i++) lfsrNoise[i].setTaps(appliedLFSRTaps);
+    }
     
-    // Process each channel
-    for (int c = 0; c < channels; c++)
+    const bool clockConnected = inputs[CLOCK_INPUT].isConnected();
+    const uint32_t clocks = clockConnected ? clockTrigger.process(inputs[CLOCK_INPUT], channels) : 0;
+    const bool slowRange = params[RANGE_PARAM].getValue() < 0.1f;
+
+    for (int c = 0; c < channels; c += 4)
     {
-        auto fluxAmount = getNormalizedModulatedValue(FLUX_PARAM, FLUX_INPUT, FLUX_SCALE_PARAM, c);
-        auto flux = fluxAmount * fluxNoise[c];
-
-        float sr = params[SRATE_PARAM].getValue() + (inputs[SRATE_INPUT].getPolyVoltage(c) * params[SRATE_SCALE_PARAM].getValue() * 0.2f);
-        sr = clamp(sr + flux, 0.01f, 1.0f);
-        float finalSr = sr*sr*sr;
-        
-        if(params[RANGE_PARAM].getValue() < 0.1f) finalSr = finalSr * 0.01f;
-        sRate[c].setSampleRateFactor(finalSr);
-        
-        bool isReady = sRate[c].readyForNextSample();
-        if(inputs[CLOCK_INPUT].isConnected()) isReady = clockTrigger[c].process(inputs[CLOCK_INPUT].getPolyVoltage(c));
-
-        float modeValue = params[MODE_PARAM].getValue() + (params[MODE_SCALE_PARAM].getValue() * inputs[MODE_INPUT].getPolyVoltage(c));
-        modeValue = clamp(modeValue, 0.0, 5.0);
-        mode[c] = (int) std::round(modeValue);
-
-        if(isReady)
-        {   
-            fluxNoise[c] = randGen[c].whiteNoise();
-            renderNoise(c);
-            slew[c].setTargetValue(outVal[c]);
+        const int block = c/4;
+
+        simd::float_4 fluxAmount = params[FLUX_PARAM].getValue() + (inputs[FLUX_INPUT].getPolyVoltageSimd<simd::float_4>(c) * params[FLUX_SCALE_PARAM].getValue());
+        fluxAmount = simd::clamp(fluxAmount * 0.1f + 0.5f, 0.0f, 1.0f);
+        const simd::float_4 flux = fluxAmount * simd::float_4::load(fluxNoise + c);
+
+        simd::float_4 sr = params[SRATE_PARAM].getValue() + (inputs[SRATE_INPUT].getPolyVoltageSimd<simd::float_4>(c) * params[SRATE_SCALE_PARAM].getValue() * 0.2f);
+        sr = simd::clamp(sr + flux, 0.01f, 1.0f);
+        simd::float_4 finalSr = sr*sr*sr;
+        if(slowRange) finalSr = finalSr * 0.01f;
+
+        simd::float_4 modeValue = params[MODE_PARAM].getValue() + (params[MODE_SCALE_PARAM].getValue() * inputs[MODE_INPUT].getPolyVoltageSimd<simd::float_4>(c));
+        const simd::float_4 modes = simd::floor(simd::clamp(modeValue, 0.0f, 5.0f) + 0.5f);
+
+        // The internal sample rate counters stay per channel
+        uint32_t readyLanes = 0;
+        const int blockChannels = std::min(4, channels - c);
+        for (int i = 0; i < blockChannels; i++)
+        {
+            sRate[c + i].setSampleRateFactor(finalSr[i]);
+            const bool isReady = sRate[c + i].readyForNextSample();
+            readyLanes |= uint32_t(isReady) << i;
+            mode[c + i] = int(modes[i]);
         }
+        if(clockConnected) readyLanes = (clocks >> c) & HCVGateLogic::blockMask(c, channels);
 
-        if(params[SLEW_PARAM].getValue() == 1.0f)
+        if(readyLanes)
         {
-            slew[c].setSRFactor(sRate[c].getSampleRateFactor());
-            outVal[c] = slew[c]();
+            const simd::float_4 ready = HCVGateLogic::bitsToLanes(readyLanes);
+
+            simd::float_4 newFlux = simd::ifelse(ready, fluxGens[block].nextFloat() * 2.0f - 1.0f, simd::float_4::load(fluxNoise + c));
+            newFlux.store(fluxNoise + c);
+
+            // Only the colors that are in use in this block are rendered
+            simd::float_4 noise = simd::float_4::load(outVal + c);
+            for (int m = 0; m < NUM_MODES; m++)
+            {
+                const simd::float_4 lanes = ready & (modes == float(m));
+                if(simd::movemask(lanes)) noise = simd::ifelse(lanes, renderNoise(m, block, lanes), noise);
+            }
+            noise.store(outVal + c);
         }
 
-        dcFilter[c].setFader(params[DC_PARAM].getValue());
-        auto filteredOut = dcFilter[c].process(outVal[c]);
+        for (int i = 0; i < blockChannels; i++)
+        {
+            const int channel = c + i;
+            if((readyLanes >> i) & 1) slew[channel].setTargetValue(outVal[channel]);
+
+            if(params[SLEW_PARAM].getValue() == 1.0f)
+            {
+                slew[channel].setSRFactor(sRate[channel].getSampleRateFactor());
+                outVal[channel] = slew[channel]();
+            }
 
-        outputs[MAIN_OUTPUT].setVoltage(filteredOut * 5.0f, c);
+            dcFilter[channel].setFader(params[DC_PARAM].getValue());
+            auto filteredOut = dcFilter[channel].process(outVal[channel]);
+
+            outputs[MAIN_OUTPUT].setVoltage(filteredOut * 5.0f, channel);
+        }
     }
 
     // Lights show the state of channel 0
@@ -185,7 +248,27 @@ void ClockedNoise::process(const ProcessArgs &args)
 }
 
 
-struct ClockedNoiseWidget : HCVModuleWidget { ClockedNoiseWidget(ClockedNoise *module); };
+struct ClockedNoiseWidget : HCVModuleWidget
+{
+    ClockedNoiseWidget(ClockedNoise *module);
+
+    void appendContextMenu(Menu *menu) override
+    {
+        ClockedNoise *noise = dynamic_cast<ClockedNoise*>(module);
+        assert(noise);
+
+        std::vector<std::string> lengthLabels;
+        for (int i = 0; i < HCVLFSRNoise4::NUM_TAPS; i++)
+        {
+            lengthLabels.push_back(std::to_string(HCVLFSRNoise4::getTaps(i).length) + " bits");
+        }
+
+        menu->addChild(new MenuSeparator());
+        menu->addChild(createIndexSubmenuItem("LFSR Length", lengthLabels,
+            [=]() { return size_t(noise->lfsrTaps); },
+            [=](size_t index) { noise->setLFSRTaps(int(index)); }));
+    }
+};
 
 ClockedNoiseWidget::ClockedNoiseWidget(ClockedNoise *module)
 {
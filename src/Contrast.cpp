@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVOversampler.h"
 
 /*                                      
  ┌─────────────────┬──────────────────┐ 
@@ -65,6 +66,27 @@ struct Contrast : HCVModule
 
 	simd::float_4 ins[4] = {0.0f, 0.0f, 0.0f, 0.0f}, contrasts[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 
+	HCVOversampler4 oversamplers[4];
+	int oversampling = 0;
+
+	void onReset() override
+	{
+		oversampling = 0;
+	}
+
+	json_t *dataToJson() override
+	{
+		json_t *rootJ = json_object();
+		json_object_set_new(rootJ, "oversampling", json_integer(oversampling));
+		return rootJ;
+	}
+
+	void dataFromJson(json_t *rootJ) override
+	{
+		json_t *oversamplingJ = json_object_get(rootJ, "oversampling");
+		if (oversamplingJ) oversampling = clamp(int(json_integer_value(oversamplingJ)), 0, HCVOversampler4::MAX_STAGES);
+	}
+
 	template <typename T = float>
 	T contrastAlgo(T _input, T _contrast)
 	{
@@ -106,7 +128,12 @@ void Contrast::process(const ProcessArgs &args)
 
 		contrasts[vectorIndex] = clamp(contrasts[vectorIndex], 0.0f, 5.0f) * 0.2f;
 
-		ins[vectorIndex] = contrastAlgo(ins[vectorIndex], contrasts[vectorIndex]);
+		const simd::float_4 contrast = contrasts[vectorIndex];
+		oversamplers[vectorIndex].setStages(oversampling);
+		ins[vectorIndex] = oversamplers[vectorIndex].process(ins[vectorIndex], [&](simd::float_4 _x)
+		{
+			return contrastAlgo(_x, contrast);
+		});
 		ins[vectorIndex] *= upscale;
 
 		ins[c / 4].store(outputs[MAIN_OUTPUT].getVoltages(c));
@@ -114,7 +141,19 @@ void Contrast::process(const ProcessArgs &args)
 }
 
 
-struct ContrastWidget : HCVModuleWidget { ContrastWidget(Contrast *module); };
+struct ContrastWidget : HCVModuleWidget
+{
+	ContrastWidget(Contrast *module);
+
+	void appendContextMenu(Menu *menu) override
+	{
+		Contrast *contrast = dynamic_cast<Contrast*>(module);
+		assert(contrast);
+
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createIndexPtrSubmenuItem("Oversampling", HCVOversampler4::getLabels(), &contrast->oversampling));
+	}
+};
 
 ContrastWidget::ContrastWidget(Contrast *module)
 {
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "rack.hpp"
+
+//Variable per-lane shifts of 32-bit words, four lanes at a time.
+//SSE has no per-lane shift amounts before AVX2, so each amount is applied one bit at a time
+//(1, 2, 4, 8, 16) by picking between the shifted and unshifted word.
+class HCVBitshift
+{
+public:
+    enum ShiftModes
+    {
+        ARITHMETIC_SHIFT,
+        LOGICAL_SHIFT,
+        ROTATE_SHIFT,
+        NUM_SHIFT_MODES
+    };
+
+    //positive _shifts shift right, negative _shifts shift left. Amounts must be in [-31, 31].
+    static rack::simd::int32_4 process(rack::simd::int32_4 _in, rack::simd::int32_4 _shifts, int _mode)
+    {
+        using rack::simd::int32_4;
+
+        if(_mode == ROTATE_SHIFT)
+        {
+            //rotating right by n is rotating left by 32 - n
+            return rotateLeft(_in, (int32_4(0) - _shifts) & int32_4(31));
+        }
+
+        //one of the two amounts is always zero, so no branch on the sign is needed
+        const int32_4 zero = int32_4(0);
+        const int32_4 leftShifts = rack::simd::ifelse(_shifts < zero, zero - _shifts, zero);
+        const int32_4 rightShifts = rack::simd::ifelse(_shifts > zero, _shifts, zero);
+
+        const int32_4 shiftedLeft = shiftLeft(_in, leftShifts);
+        if(_mode == LOGICAL_SHIFT) return shiftRightLogical(shiftedLeft, rightShifts);
+        return shiftRightArithmetic(shiftedLeft, rightShifts);
+    }
+
+    //keeps the top _bitDepth bits of each word
+    static rack::simd::int32_4 getDepthMask(int _bitDepth)
+    {
+        const int droppedBits = 32 - std::max(1, std::min(32, _bitDepth));
+        return rack::simd::int32_4(int32_t(~uint32_t(0) << droppedBits));
+    }
+
+    static rack::simd::int32_4 shiftLeft(rack::simd::int32_4 _in, rack::simd::int32_4 _shifts)
+    {
+#if defined(__AVX2__)
+        return rack::simd::int32_4(_mm_sllv_epi32(_in.v, _shifts.v));
+#else
+        __m128i x = _in.v;
+        x = select(_shifts, 1, _mm_slli_epi32(x, 1), x);
+        x = select(_shifts, 2, _mm_slli_epi32(x, 2), x);
+        x = select(_shifts, 4, _mm_slli_epi32(x, 4), x);
+        x = select(_shifts, 8, _mm_slli_epi32(x, 8), x);
+        x = select(_shifts, 16, _mm_slli_epi32(x, 16), x);
+        return rack::simd::int32_4(x);
+#endif
+    }
+
+    static rack::simd::int32_4 shiftRightArithmetic(rack::simd::int32_4 _in, rack::simd::int32_4 _shifts)
+    {
+#if defined(__AVX2__)
+        return rack::simd::int32_4(_mm_srav_epi32(_in.v, _shifts.v));
+#else
+        __m128i x = _in.v;
+        x = select(_shifts, 1, _mm_srai_epi32(x, 1), x);
+        x = select(_shifts, 2, _mm_srai_epi32(x, 2), x);
+        x = select(_shifts, 4, _mm_srai_epi32(x, 4), x);
+        x = select(_shifts, 8, _mm_srai_epi32(x, 8), x);
+        x = select(_shifts, 16, _mm_srai_epi32(x, 16), x);
+        return rack::simd::int32_4(x);
+#endif
+    }
+
+    static rack::simd::int32_4 shiftRightLogical(rack::simd::int32_4 _in, rack::simd::int32_4 _shifts)
+    {
+#if defined(__AVX2__)
+        return rack::simd::int32_4(_mm_srlv_epi32(_in.v, _shifts.v));
+#else
+        __m128i x = _in.v;
+        x = select(_shifts, 1, _mm_srli_epi32(x, 1), x);
+        x = select(_shifts, 2, _mm_srli_epi32(x, 2), x);
+        x = select(_shifts, 4, _mm_srli_epi32(x, 4), x);
+        x = select(_shifts, 8, _mm_srli_epi32(x, 8), x);
+        x = select(_shifts, 16, _mm_srli_epi32(x, 16), x);
+        return rack::simd::int32_4(x);
+#endif
+    }
+
+    //_shifts must be in [0, 31]
+    static rack::simd::int32_4 rotateLeft(rack::simd::int32_4 _in, rack::simd::int32_4 _shifts)
+    {
+        const rack::simd::int32_4 rotated = shiftLeft(_in, _shifts) | shiftRightLogical(_in, rack::simd::int32_4(32) - _shifts);
+
+        //a shift of 32 isn't defined for every path, so rotating by 0 is handled here
+        return rack::simd::ifelse(_shifts == rack::simd::int32_4(0), _in, rotated);
+    }
+
+private:
+    //picks _shifted for the lanes whose amount has _bit set
+    static __m128i select(rack::simd::int32_4 _shifts, int _bit, __m128i _shifted, __m128i _unshifted)
+    {
+        const __m128i bit = _mm_set1_epi32(_bit);
+        const __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(_shifts.v, bit), bit);
+        return _mm_or_si128(_mm_and_si128(mask, _shifted), _mm_andnot_si128(mask, _unshifted));
+    }
+};
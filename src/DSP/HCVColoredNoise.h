@@ -0,0 +1,100 @@
+#pragma once
+
+#include "rack.hpp"
+#include "HCVRandom.h"
+
+//Four-channel noise generators. Each process() call only advances the lanes set in _mask,
+//so channels that aren't clocked hold their state.
+
+class HCVWhiteNoise4
+{
+public:
+    // [-1, 1)
+    rack::simd::float_4 process(rack::simd::float_4 _mask)
+    {
+        return randGen.nextFloat() * 2.0f - 1.0f;
+    }
+
+private:
+    HCVRandom4 randGen;
+};
+
+//Paul Kellet's economy pink filter applied to white noise
+class HCVPinkNoise4
+{
+public:
+    rack::simd::float_4 process(rack::simd::float_4 _mask)
+    {
+        const rack::simd::float_4 white = randGen.nextFloat() * 2.0f - 1.0f;
+
+        b0 = rack::simd::ifelse(_mask, b0 * 0.99765f + white * 0.0990460f, b0);
+        b1 = rack::simd::ifelse(_mask, b1 * 0.96300f + white * 0.2965164f, b1);
+        b2 = rack::simd::ifelse(_mask, b2 * 0.57000f + white * 1.0526913f, b2);
+
+        return (b0 + b1 + b2 + white * 0.1848f) * 0.2f;
+    }
+
+private:
+    HCVRandom4 randGen;
+    rack::simd::float_4 b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+};
+
+//random walk that reflects off of -1 and 1
+class HCVBrownNoise4
+{
+public:
+    rack::simd::float_4 process(rack::simd::float_4 _mask)
+    {
+        rack::simd::float_4 next = value + (randGen.nextFloat() * 2.0f - 1.0f) * step;
+        next = rack::simd::ifelse(next > 1.0f, 2.0f - next, next);
+        next = rack::simd::ifelse(next < -1.0f, -2.0f - next, next);
+
+        value = rack::simd::ifelse(_mask, next, value);
+        return value;
+    }
+
+private:
+    HCVRandom4 randGen;
+    rack::simd::float_4 value = 0.0f;
+    float step = 0.04f;
+};
+
+//flips one random bit of a 31-bit word each step, like HCVGrayNoise
+class HCVGrayNoise4
+{
+public:
+    rack::simd::float_4 process(rack::simd::float_4 _mask)
+    {
+        //1 << bit, built as the float 2^bit so no variable shift is needed
+        const __m128i bit = _mm_cvttps_epi32((randGen.nextFloat() * 31.0f).v);
+        const __m128i powerOfTwo = _mm_cvttps_epi32(_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(bit, _mm_set1_epi32(127)), 23)));
+
+        const __m128i next = _mm_xor_si128(lastNoise, powerOfTwo);
+        const __m128i mask = _mm_castps_si128(_mask.v);
+        lastNoise = _mm_or_si128(_mm_and_si128(mask, next), _mm_andnot_si128(mask, lastNoise));
+
+        const rack::simd::float_4 output = rack::simd::float_4(_mm_cvtepi32_ps(lastNoise)) * 4.65661287308e-10f;
+        return rack::simd::clamp((output - 0.5f) * 2.0f, -1.0f, 1.0f);
+    }
+
+private:
+    HCVRandom4 randGen;
+    __m128i lastNoise = _mm_setzero_si128();
+};
+
+//Box-Muller, scaled like HCVRandom::nextGaussian()
+class HCVGaussianNoise4
+{
+public:
+    rack::simd::float_4 process(rack::simd::float_4 _mask)
+    {
+        const rack::simd::float_4 u1 = 1.0f - randGen.nextFloat();
+        const rack::simd::float_4 u2 = randGen.nextFloat();
+
+        const rack::simd::float_4 radius = rack::simd::sqrt(-2.0f * rack::simd::log(u1));
+        return radius * rack::simd::cos(u2 * float(2.0 * M_PI)) * 0.3f;
+    }
+
+private:
+    HCVRandom4 randGen;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "rack.hpp"
+
+//Quantizes four channels at a time to words of up to 16 bits, and turns words back into voltages.
+//Bits are read out of the words with vector shifts and compares, so every bit depth uses the same code.
+class HCVDataConverter
+{
+public:
+    enum Modes
+    {
+        UNIPOLAR,           //[0, 1] across the whole word
+        BIPOLAR_OFFSET,     //[-1, 1] offset to [0, 1]
+        BIPOLAR_SIGNED,     //the top bit is the sign, the rest hold the magnitude
+        NUM_MODES
+    };
+
+    static constexpr int MAX_BITS = 16;
+
+    //_in is normalized to [0, 1] or [-1, 1] depending on _mode
+    static rack::simd::int32_4 encode(rack::simd::float_4 _in, int _mode, int _bits)
+    {
+        using rack::simd::float_4;
+        using rack::simd::int32_4;
+
+        if(_mode == BIPOLAR_SIGNED)
+        {
+            const float_4 magnitude = rack::simd::fabs(rack::simd::clamp(_in, -1.0f, 1.0f));
+            const int32_4 sign = int32_4::cast(_in < 0.0f) & int32_4(1 << (_bits - 1));
+            return quantize(magnitude, getMaxValue(_bits - 1)) | sign;
+        }
+
+        if(_mode == BIPOLAR_OFFSET) _in = (rack::simd::clamp(_in, -1.0f, 1.0f) + 1.0f) * 0.5f;
+        return quantize(rack::simd::clamp(_in, 0.0f, 1.0f), getMaxValue(_bits));
+    }
+
+    //the inverse of encode()
+    static rack::simd::float_4 decode(rack::simd::int32_4 _words, int _mode, int _bits)
+    {
+        using rack::simd::float_4;
+        using rack::simd::int32_4;
+
+        if(_mode == BIPOLAR_SIGNED)
+        {
+            const int magnitudeMax = getMaxValue(_bits - 1);
+            const float_4 magnitude = float_4(_words & int32_4(magnitudeMax));
+            const float_4 negative = float_4::cast(getBit(_words, _bits - 1));
+
+            //a 1-bit word is only a sign
+            const float_4 output = magnitudeMax > 0 ? magnitude/float(magnitudeMax) : float_4(0.0f);
+            return rack::simd::ifelse(negative, -output, output);
+        }
+
+        const float_4 output = float_4(_words & int32_4(getMaxValue(_bits)))/float(getMaxValue(_bits));
+        if(_mode == BIPOLAR_OFFSET) return output * 2.0f - 1.0f;
+        return output;
+    }
+
+    //all bits set in the lanes whose word has bit _bit set
+    static rack::simd::int32_4 getBit(rack::simd::int32_4 _words, int _bit)
+    {
+        const rack::simd::int32_4 one = rack::simd::int32_4(1);
+        return ((_words >> _bit) & one) == one;
+    }
+
+    //word with bit _bit set in the lanes set in _mask
+    static rack::simd::int32_4 setBit(rack::simd::float_4 _mask, int _bit)
+    {
+        return rack::simd::int32_4::cast(_mask) & rack::simd::int32_4(1 << _bit);
+    }
+
+    static int getMaxValue(int _bits)
+    {
+        return (1 << _bits) - 1;
+    }
+
+private:
+    //rounds half away from zero for non-negative inputs, like std::round
+    static rack::simd::int32_4 quantize(rack::simd::float_4 _in, int _maxValue)
+    {
+        return rack::simd::int32_4(_in * float(_maxValue) + 0.5f);
+    }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "dsp/common.hpp"
+#include "simd/functions.hpp"
 
 constexpr auto HALF_PI = 1.57079632679f;
 constexpr auto PI = 3.14159265359f;
@@ -24,4 +25,76 @@ template <typename T = float>
 inline T SIMDLERP(const T _amountOfA, const T _inA, const T _inB)
 {
     return ((_amountOfA*_inA)+((1.0f-_amountOfA)*_inB));
-}
\ No newline at end of file
+}
+
+//Vector log2 for x > 0. The mantissa is reduced to [sqrt(0.5), sqrt(2)) and log is taken with
+//the atanh series, so the error is at the level of float rounding. log2(0) returns -127.
+inline rack::simd::float_4 fastLog2(rack::simd::float_4 _x)
+{
+    using rack::simd::float_4;
+    using rack::simd::int32_4;
+
+    const int32_4 bits = int32_4::cast(_x);
+    float_4 exponent = float_4(((bits >> 23) & int32_4(0xFF)) - int32_4(127));
+    float_4 mantissa = float_4::cast((bits & int32_4(0x007FFFFF)) | int32_4(0x3F800000));
+
+    const float_4 large = mantissa > 1.41421356237f;
+    mantissa = rack::simd::ifelse(large, mantissa * 0.5f, mantissa);
+    exponent += rack::simd::ifelse(large, 1.0f, 0.0f);
+
+    const float_4 s = (mantissa - 1.0f)/(mantissa + 1.0f);
+    const float_4 s2 = s * s;
+    const float_4 series = 1.0f + s2 * (1.0f/3.0f + s2 * (1.0f/5.0f + s2 * (1.0f/7.0f + s2 * (1.0f/9.0f))));
+
+    return exponent + (2.0f * 1.44269504089f) * s * series;
+}
+
+//Vector 2^x, clamped to the normal float range. The fraction is reduced to [-0.5, 0.5] for a
+//degree 6 Taylor series, which is accurate to about 1e-7.
+inline rack::simd::float_4 fastExp2(rack::simd::float_4 _x)
+{
+    using rack::simd::float_4;
+    using rack::simd::int32_4;
+
+    const float_4 x = rack::simd::clamp(_x, -126.0f, 126.0f);
+    const float_4 whole = rack::simd::floor(x + 0.5f);
+    const float_4 f = (x - whole) * 0.69314718056f;
+
+    const float_4 fraction = 1.0f + f * (1.0f + f * (1.0f/2.0f + f * (1.0f/6.0f + f * (1.0f/24.0f + f * (1.0f/120.0f + f * (1.0f/720.0f))))));
+    const float_4 power = float_4::cast((int32_4(whole) + int32_4(127)) << 23);
+
+    return power * fraction;
+}
+
+//Vector atan. Abramowitz and Stegun 4.4.49 on [0, 1], with atan(x) = PI/2 - atan(1/x) above that.
+inline rack::simd::float_4 fastArcTangent(rack::simd::float_4 _x)
+{
+    using rack::simd::float_4;
+
+    const float_4 x = rack::simd::fabs(_x);
+    const float_4 inverted = x > 1.0f;
+    const float_4 t = rack::simd::ifelse(inverted, 1.0f/x, x);
+
+    const float_4 t2 = t * t;
+    const float_4 poly = t * (1.0f + t2 * (-0.3333314528f + t2 * (0.1999355085f + t2 * (-0.1420889944f
+        + t2 * (0.1065626393f + t2 * (-0.0752896400f + t2 * (0.0429096138f + t2 * (-0.0161657367f + t2 * 0.0028662257f))))))));
+
+    const float_4 positive = rack::simd::ifelse(inverted, HALF_PI - poly, poly);
+    return rack::simd::ifelse(_x < 0.0f, -positive, positive);
+}
+
+//Vector atan2 in [-PI, PI]. The ratio is always in [0, 1], and atan2(0, 0) is 0.
+inline rack::simd::float_4 fastArcTangent2(rack::simd::float_4 _y, rack::simd::float_4 _x)
+{
+    using rack::simd::float_4;
+
+    const float_4 absX = rack::simd::fabs(_x);
+    const float_4 absY = rack::simd::fabs(_y);
+    const float_4 larger = rack::simd::fmax(absX, absY);
+    const float_4 ratio = rack::simd::ifelse(larger > 0.0f, rack::simd::fmin(absX, absY)/larger, 0.0f);
+
+    float_4 angle = fastArcTangent(ratio);
+    angle = rack::simd::ifelse(absY > absX, HALF_PI - angle, angle);
+    angle = rack::simd::ifelse(_x < 0.0f, PI - angle, angle);
+    return rack::simd::ifelse(_y < 0.0f, -angle, angle);
+}
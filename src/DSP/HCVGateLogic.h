@@ -0,0 +1,135 @@
+#pragma once
+
+#include "rack.hpp"
+
+//Gate logic for up to 16 channels packed into a bitmask. Bit c holds the state of channel c,
+//so logic operations on every channel are single integer operations.
+class HCVGateLogic
+{
+public:
+    //bits set for channels [0, _channels)
+    static uint32_t channelMask(int _channels)
+    {
+        return (uint32_t(1) << _channels) - 1;
+    }
+
+    //bits set for the lanes of a four-channel block that are below _channels
+    static uint32_t blockMask(int _firstChannel, int _channels)
+    {
+        return channelMask(std::min(4, std::max(0, _channels - _firstChannel)));
+    }
+
+    //returns a mask that is set for each lane whose bit is set in the low four bits of _bits
+    static rack::simd::float_4 bitsToLanes(uint32_t _bits)
+    {
+        const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+        const __m128i bits = _mm_and_si128(_mm_set1_epi32(int32_t(_bits)), lanes);
+        return rack::simd::float_4(_mm_castsi128_ps(_mm_cmpeq_epi32(bits, lanes)));
+    }
+
+    //channels whose polyphonic voltage is at or above _threshold
+    static uint32_t getGates(rack::engine::Input& _input, int _channels, float _threshold = 1.0f)
+    {
+        uint32_t gates = 0;
+        for (int c = 0; c < _channels; c += 4)
+        {
+            const rack::simd::float_4 voltages = _input.getPolyVoltageSimd<rack::simd::float_4>(c);
+            gates |= uint32_t(rack::simd::movemask(voltages >= _threshold)) << c;
+        }
+        return gates & channelMask(_channels);
+    }
+
+    static void setGates(rack::engine::Output& _output, uint32_t _gates, int _channels, float _gateMagnitude = 10.0f)
+    {
+        for (int c = 0; c < _channels; c += 4)
+        {
+            _output.setVoltageSimd(rack::simd::ifelse(bitsToLanes(_gates >> c), _gateMagnitude, 0.0f), c);
+        }
+    }
+};
+
+//16 channels of HysteresisGate. Goes high above trueBound and low below falseBound.
+class HCVHysteresisBank
+{
+public:
+    uint32_t process(rack::engine::Input& _input, int _channels)
+    {
+        uint32_t high = 0, low = 0;
+        for (int c = 0; c < _channels; c += 4)
+        {
+            const rack::simd::float_4 voltages = _input.getPolyVoltageSimd<rack::simd::float_4>(c);
+            high |= uint32_t(rack::simd::movemask(voltages > trueBound)) << c;
+            low |= uint32_t(rack::simd::movemask(voltages < falseBound)) << c;
+        }
+
+        //channels above _channels keep their state, like the per-channel gates did
+        const uint32_t active = HCVGateLogic::channelMask(_channels);
+        const uint32_t newState = high | (state & ~low);
+        state = (state & ~active) | (newState & active);
+        return state & active;
+    }
+
+    uint32_t getState() const { return state; }
+
+    float trueBound = 1.0f;
+    float falseBound = 0.98f;
+
+private:
+    uint32_t state = 0;
+};
+
+//16 channels of dsp::SchmittTrigger. Each call returns a bitmask of rising edges.
+class HCVSchmittBank
+{
+public:
+    //processes one four-channel block. Only the lanes below _channels are updated.
+    uint32_t process(int _firstChannel, rack::simd::float_4 _in, int _channels = 16)
+    {
+        const uint32_t active = HCVGateLogic::blockMask(_firstChannel, _channels) << _firstChannel;
+        const uint32_t on = uint32_t(rack::simd::movemask(_in >= highThreshold)) << _firstChannel;
+        const uint32_t off = uint32_t(rack::simd::movemask(_in <= lowThreshold)) << _firstChannel;
+
+        const uint32_t triggered = ~state & on & active;
+        state = (state & ~active) | ((on | (state & ~off)) & active);
+        return triggered;
+    }
+
+    //polyphonic input, with _firstChannelOffset added to channel 0 only (for panel buttons)
+    uint32_t process(rack::engine::Input& _input, int _channels, float _firstChannelOffset = 0.0f)
+    {
+        uint32_t triggered = 0;
+        for (int c = 0; c < _channels; c += 4)
+        {
+            rack::simd::float_4 voltages = _input.getPolyVoltageSimd<rack::simd::float_4>(c);
+            if(c == 0) voltages += rack::simd::float_4(_firstChannelOffset, 0.0f, 0.0f, 0.0f);
+            triggered |= process(c, voltages, _channels);
+        }
+        return triggered;
+    }
+
+    //all channels at once, e.g. from Port::getVoltages()
+    uint32_t process(const float* _voltages, int _channels)
+    {
+        uint32_t triggered = 0;
+        for (int c = 0; c < _channels; c += 4)
+        {
+            triggered |= process(c, rack::simd::float_4::load(_voltages + c), _channels);
+        }
+        return triggered;
+    }
+
+    void setThresholds(float _low, float _high)
+    {
+        lowThreshold = _low;
+        highThreshold = _high;
+    }
+
+    //dsp::SchmittTrigger starts high, so an input that is already high doesn't trigger
+    void reset() { state = ~uint32_t(0); }
+    uint32_t getState() const { return state; }
+
+private:
+    uint32_t state = ~uint32_t(0);
+    float lowThreshold = 0.0f;
+    float highThreshold = 1.0f;
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "rack.hpp"
+#include "HCVFunctions.h"
+
+//Half-band lowpass for 2x up and downsampling, four channels at a time.
+//39 tap Kaiser windowed sinc with about 60dB of stopband rejection. Every even tap except the
+//center is zero, so only the odd phase is filtered and the even phase is a plain delay.
+class HCVHalfBand4
+{
+public:
+    static constexpr int NUM_COEFFICIENTS = 10;
+
+    //one sample in, two samples out
+    void upsample(rack::simd::float_4 _in, rack::simd::float_4* _out)
+    {
+        upHistory.push(_in);
+        const rack::simd::float_4* history = upHistory.get();
+
+        _out[0] = filterOddPhase(history) * 2.0f;
+        _out[1] = history[NUM_COEFFICIENTS - 1];
+    }
+
+    //two samples in, one sample out
+    rack::simd::float_4 downsample(const rack::simd::float_4* _in)
+    {
+        evenHistory.push(_in[0]);
+        oddHistory.push(_in[1]);
+
+        return evenHistory.get()[NUM_COEFFICIENTS - 1] * 0.5f + filterOddPhase(oddHistory.get());
+    }
+
+private:
+    //symmetric taps at odd offsets from the center
+    static rack::simd::float_4 filterOddPhase(const rack::simd::float_4* _history)
+    {
+        static const float coefficients[NUM_COEFFICIENTS] = {
+            0.3162542858f, -0.0997714756f, 0.0535393380f, -0.0322144129f, 0.0197679565f,
+            -0.0118438925f, 0.0067120680f, -0.0034731373f, 0.0015501971f, -0.0005209272f
+        };
+
+        rack::simd::float_4 sum = 0.0f;
+        for (int i = 0; i < NUM_COEFFICIENTS; i++)
+        {
+            sum += (_history[NUM_COEFFICIENTS + i] + _history[NUM_COEFFICIENTS - 1 - i]) * coefficients[i];
+        }
+        return sum;
+    }
+
+    //newest sample first. Every sample is written twice so the history is always contiguous.
+    struct History
+    {
+        static constexpr int SIZE = 2 * NUM_COEFFICIENTS;
+
+        void push(rack::simd::float_4 _sample)
+        {
+            position = (position == 0 ? SIZE : position) - 1;
+            samples[position] = _sample;
+            samples[position + SIZE] = _sample;
+        }
+
+        const rack::simd::float_4* get() const { return samples + position; }
+
+        rack::simd::float_4 samples[2 * SIZE] = {};
+        int position = 0;
+    };
+
+    History upHistory, evenHistory, oddHistory;
+};
+
+//Cascaded half-band stages for 1x, 2x, 4x or 8x oversampling of a four channel block
+class HCVOversampler4
+{
+public:
+    static constexpr int MAX_STAGES = 3;
+    static constexpr int MAX_FACTOR = 1 << MAX_STAGES;
+
+    static std::vector<std::string> getLabels()
+    {
+        return {"Off", "2x", "4x", "8x"};
+    }
+
+    //the oversampling factor is 2^_stages. Filters are cleared when it changes.
+    void setStages(int _stages)
+    {
+        _stages = rack::math::clamp(_stages, 0, int(MAX_STAGES));
+        if(_stages == stages) return;
+
+        stages = _stages;
+        for (int i = 0; i < MAX_STAGES; i++) halfBands[i] = HCVHalfBand4();
+    }
+
+    int getFactor() const { return 1 << stages; }
+
+    //_out must hold getFactor() samples
+    void upsample(rack::simd::float_4 _in, rack::simd::float_4* _out)
+    {
+        _out[0] = _in;
+        for (int stage = 0; stage < stages; stage++)
+        {
+            const int count = 1 << stage;
+
+            rack::simd::float_4 lowRate[MAX_FACTOR];
+            for (int i = 0; i < count; i++) lowRate[i] = _out[i];
+            for (int i = 0; i < count; i++) halfBands[stage].upsample(lowRate[i], _out + 2*i);
+        }
+    }
+
+    //reads getFactor() samples from _in, and uses it as scratch space
+    rack::simd::float_4 downsample(rack::simd::float_4* _in)
+    {
+        for (int stage = stages - 1; stage >= 0; stage--)
+        {
+            const int count = 1 << stage;
+            for (int i = 0; i < count; i++) _in[i] = halfBands[stage].downsample(_in + 2*i);
+        }
+        return _in[0];
+    }
+
+    //runs _shaper at the oversampled rate
+    template <typename F>
+    rack::simd::float_4 process(rack::simd::float_4 _in, F _shaper)
+    {
+        if(stages == 0) return _shaper(_in);
+
+        rack::simd::float_4 buffer[MAX_FACTOR];
+        upsample(_in, buffer);
+
+        const int factor = getFactor();
+        for (int i = 0; i < factor; i++) buffer[i] = _shaper(buffer[i]);
+
+        return downsample(buffer);
+    }
+
+private:
+    HCVHalfBand4 halfBands[MAX_STAGES];
+    int stages = 0;
+};
+
+//First order antiderivative anti-aliasing: the average of the shaper between the last two inputs,
+//computed from its antiderivative. Close inputs fall back to the shaper at the midpoint.
+class HCVADAA4
+{
+public:
+    template <typename F, typename AD>
+    rack::simd::float_4 process(rack::simd::float_4 _in, F _function, AD _antiderivative)
+    {
+        const rack::simd::float_4 difference = _in - lastInput;
+        const rack::simd::float_4 averaged = (_antiderivative(_in) - _antiderivative(lastInput)) / difference;
+        const rack::simd::float_4 midpoint = _function((_in + lastInput) * 0.5f);
+
+        lastInput = _in;
+        return rack::simd::ifelse(rack::simd::fabs(difference) < 1e-3f, midpoint, averaged);
+    }
+
+    void reset() { lastInput = 0.0f; }
+
+private:
+    rack::simd::float_4 lastInput = 0.0f;
+};
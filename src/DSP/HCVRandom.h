@@ -3,6 +3,8 @@
 #include "Gamma/rnd.h"
 #include "HCVFunctions.h"
 #include "math.hpp"
+#include "random.hpp"
+#include "simd/functions.hpp"
 
 class HCVRandom
 {
@@ -59,6 +61,45 @@ private:
     gam::RNGMulCon gamRand;
 };
 
+//Four independent xorshift32 generators, one per SIMD lane.
+//Each instance owns its state, so it never locks or shares state with other modules.
+class HCVRandom4
+{
+public:
+    HCVRandom4()
+    {
+        seed(rack::random::u32());
+    }
+
+    void seed(uint32_t _seed)
+    {
+        //xorshift32 must never be seeded with 0
+        uint32_t laneSeeds[4];
+        for (int i = 0; i < 4; i++)
+        {
+            _seed = _seed * 1664525u + 1013904223u;
+            laneSeeds[i] = _seed ? _seed : 0x9E3779B9u;
+        }
+        state = _mm_loadu_si128((const __m128i*) laneSeeds);
+    }
+
+    // [0, 1), 24 bits per lane
+    rack::simd::float_4 nextFloat()
+    {
+        __m128i x = state;
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+        state = x;
+
+        const __m128 bits = _mm_cvtepi32_ps(_mm_srli_epi32(x, 8));
+        return rack::simd::float_4(bits) * (1.0f / 16777216.0f);
+    }
+
+private:
+    __m128i state;
+};
+
 class HCVGrayNoise
 {
 public:
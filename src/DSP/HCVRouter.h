@@ -0,0 +1,104 @@
+#pragma once
+
+#include "rack.hpp"
+
+//Table-driven routing of eight stages, four channels at a time.
+//A route lists the input stage read by each output, so routing is a copy per output instead of
+//a modulo per output. Every (rotation, stage count) pair of Rotator has a precomputed route.
+class HCVRouter8
+{
+public:
+    static constexpr int NUM_STAGES = 8;
+    static constexpr int NUM_ROUTES = NUM_STAGES * NUM_STAGES;
+
+    struct Route
+    {
+        uint8_t sources[NUM_STAGES];
+    };
+
+    //_rotation in [0, 7], _stages in [1, 8]
+    static int getRouteIndex(int _rotation, int _stages)
+    {
+        return _rotation * NUM_STAGES + (_stages - 1);
+    }
+
+    //output i reads input (stages - rotation + i) mod stages, wrapped to a valid stage when rotation > stages
+    static const Route& getRotation(int _routeIndex)
+    {
+        static const RotationTable table;
+        return table.routes[_routeIndex];
+    }
+
+    //the stages of _permutation that are below _stages, in order, repeated across all outputs
+    static Route fromPermutation(const uint8_t* _permutation, int _stages)
+    {
+        uint8_t order[NUM_STAGES];
+        int count = 0;
+        for (int i = 0; i < NUM_STAGES; i++)
+        {
+            if(_permutation[i] < _stages) order[count++] = _permutation[i];
+        }
+
+        Route route;
+        for (int i = 0; i < NUM_STAGES; i++) route.sources[i] = order[i % count];
+        return route;
+    }
+
+    //Fisher-Yates shuffle of [0, 7]
+    static void randomPermutation(uint8_t* _permutation)
+    {
+        for (int i = 0; i < NUM_STAGES; i++) _permutation[i] = i;
+        for (int i = NUM_STAGES - 1; i > 0; i--)
+        {
+            const int j = rack::random::u32() % (i + 1);
+            std::swap(_permutation[i], _permutation[j]);
+        }
+    }
+
+    static bool isPermutation(const uint8_t* _permutation)
+    {
+        int seen = 0;
+        for (int i = 0; i < NUM_STAGES; i++)
+        {
+            if(_permutation[i] >= NUM_STAGES) return false;
+            seen |= 1 << _permutation[i];
+        }
+        return seen == (1 << NUM_STAGES) - 1;
+    }
+
+    //routes a four-channel block of every stage, lane l following _routes[l]
+    static void process(const rack::simd::float_4* _ins, rack::simd::float_4* _outs, const Route* const* _routes)
+    {
+        if(_routes[0] == _routes[1] && _routes[0] == _routes[2] && _routes[0] == _routes[3])
+        {
+            const Route& route = *_routes[0];
+            for (int i = 0; i < NUM_STAGES; i++) _outs[i] = _ins[route.sources[i]];
+            return;
+        }
+
+        //lanes disagree, so each one is gathered from its own route
+        for (int lane = 0; lane < 4; lane++)
+        {
+            const Route& route = *_routes[lane];
+            for (int i = 0; i < NUM_STAGES; i++) _outs[i][lane] = _ins[route.sources[i]][lane];
+        }
+    }
+
+private:
+    struct RotationTable
+    {
+        RotationTable()
+        {
+            for (int rotation = 0; rotation < NUM_STAGES; rotation++)
+            {
+                for (int stages = 1; stages <= NUM_STAGES; stages++)
+                {
+                    Route& route = routes[getRouteIndex(rotation, stages)];
+                    for (int i = 0; i < NUM_STAGES; i++) route.sources[i] = ((stages - rotation + i) % stages + stages) % stages;
+                }
+            }
+        }
+
+        Route routes[NUM_ROUTES];
+    };
+};
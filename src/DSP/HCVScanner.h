@@ -2,93 +2,118 @@
 
 #include "../HetrickUtilities.hpp"
 
+//Scans a crossfade window across up to 16 stages. The scan settings of four channels are prepared
+//together, then each channel computes its stage multipliers four stages at a time.
 class HCVScanner
 {
 public:
-    HCVScanner(int _numSteps = 8)
-    {
-        setNumStages(2);
-    }
+    static constexpr int MIN_STAGES = 2;
+    static constexpr int MAX_STAGES = 16;
+    static constexpr int MAX_VECTORS = MAX_STAGES/4;
 
-    void setNumStages(int _numStages)
+    //_stages holds the stage count of each of the four channels, the other settings are in [0, 1]
+    void setParameters(const int* _stages, rack::simd::float_4 _scan, rack::simd::float_4 _width, rack::simd::float_4 _slope)
     {
-        numStages = clamp(_numStages, 2, 8);
-        invStages = 1.0f/numStages;
-        halfStages = numStages * 0.5f;
-        remainInvStages = 1.0f - invStages;
-    }
+        using rack::simd::float_4;
 
-    void setWidthParameter(float _width)
-    {
-        width = clamp(_width * _width, 0.0f, 1.0f) * widthTable[numStages];
-    }
+        float_4 numStages, invStages, halfStages, remainInvStages, widthScale;
+        for (int lane = 0; lane < 4; lane++)
+        {
+            const StageFactors& factors = getStageFactors(_stages[lane]);
+            numStages[lane] = factors.numStages;
+            invStages[lane] = factors.invStages;
+            halfStages[lane] = factors.halfStages;
+            remainInvStages[lane] = factors.remainInvStages;
+            widthScale[lane] = factors.widthScale;
+            subStages[lane] = factors.subStages;
+        }
 
-    void setScanParameter(float _scan)
-    {
-        scan = _scan;
-    }
+        const float_4 width = rack::simd::clamp(_width * _width, 0.0f, 1.0f) * widthScale;
 
-    void setSlopeParameter(float _slope)
-    {
+        const float_4 scanFactor1 = width * halfStages + (1.0f - width) * invStages;
+        const float_4 scanFactor2 = width * (halfStages + remainInvStages) + (1.0f - width) * 1.0f;
+        scanFinal = _scan * scanFactor2 + (1.0f - _scan) * scanFactor1;
+        invWidth = 1.0f/(width * numStages + (1.0f - width) * (invStages + invStages));
         slope = _slope;
     }
 
-    void process()
+    //_numVectors blocks of four stages for one channel: _ins to _outs, with the multipliers in _mults
+    void process(int _lane, int _numVectors, const rack::simd::float_4* _ins, rack::simd::float_4* _outs, rack::simd::float_4* _mults) const
     {
-        const float scanFactor1 = LERP(width, halfStages, invStages);
-        const float scanFactor2 = LERP(width, halfStages + remainInvStages, 1.0f);
-        const float scanFinal = LERP(scan, scanFactor2, scanFactor1);
-        const float invWidth = 1.0f/(LERP(width, float(numStages), invStages+invStages));
+        using rack::simd::float_4;
 
-        float subStage = 0.0f;
-        for(int i = 0; i < 8; i++)
+        const float_4 laneScan = scanFinal[_lane];
+        const float_4 laneInvWidth = invWidth[_lane];
+        const float_4 laneSlope = slope[_lane];
+
+        for (int i = 0; i < _numVectors; i++)
         {
-            float mult = (scanFinal + subStage) * invWidth;
-            mult = clamp(mult, 0.0f, 1.0f);
-            mult = triShape(mult);
-            mult = clamp(mult, 0.0f, 1.0f);
+            float_4 mult = (laneScan + subStages[_lane][i]) * laneInvWidth;
+            mult = rack::simd::clamp(mult, 0.0f, 1.0f);
 
-            const float shaped = mult * (2.0f - mult);
-            inMults[i] = LERP(slope, shaped, mult);
+            //triangle, with round() of [0, 1] as a compare
+            mult = mult - rack::simd::ifelse(mult >= 0.5f, 1.0f, 0.0f);
+            mult = rack::simd::fabs(mult + mult);
+            mult = rack::simd::clamp(mult, 0.0f, 1.0f);
 
-            outs[i] = ins[i] * inMults[i];
-            
-            subStage -= invStages;
+            const float_4 shaped = mult * (2.0f - mult);
+            _mults[i] = laneSlope * shaped + (1.0f - laneSlope) * mult;
+            _outs[i] = _ins[i] * _mults[i];
         }
     }
 
-    void setInput(int i, float _value)
+private:
+    struct StageFactors
     {
-        ins[i] = _value;
-    }
+        float numStages;
+        float invStages;
+        float halfStages;
+        float remainInvStages;
+        float widthScale;
 
-    float getOutput(int i)
-    {
-        return outs[i];
-    }
+        //0, -1/n, -2/n, ... as repeated subtraction, like the original per-stage loop
+        rack::simd::float_4 subStages[MAX_VECTORS];
+    };
 
-    float getMult(int i)
+    static const StageFactors& getStageFactors(int _stages)
     {
-        return inMults[i];
+        static const StageFactorTable table;
+        return table.factors[clamp(_stages, int(MIN_STAGES), int(MAX_STAGES))];
     }
 
-protected:
-    float ins[8] = {};
-    float outs[8] = {};
-    float inMults[8] = {};
-    const float widthTable[9] = {0, 0, 0, 0.285, 0.285, 0.2608, 0.23523, 0.2125, 0.193};
-
-    inline float triShape(float _in)
+    struct StageFactorTable
     {
-        _in = _in - std::round(_in);
-        return std::abs(_in + _in);
-    }
+        StageFactorTable()
+        {
+            //widths up to 8 stages were tuned by ear, the rest follow their 1.943/n - 3.19/n^2 curve
+            const float widthTable[MAX_STAGES + 1] = {0, 0, 0, 0.285, 0.285, 0.2608, 0.23523, 0.2125, 0.193,
+                0.17651, 0.1624, 0.15027, 0.13976, 0.13059, 0.12251, 0.11536, 0.10898};
+
+            for (int n = 0; n <= MAX_STAGES; n++)
+            {
+                StageFactors& stageFactors = factors[n];
+                const int stages = std::max(int(MIN_STAGES), n);
+
+                stageFactors.numStages = stages;
+                stageFactors.invStages = 1.0f/stages;
+                stageFactors.halfStages = stages * 0.5f;
+                stageFactors.remainInvStages = 1.0f - stageFactors.invStages;
+                stageFactors.widthScale = widthTable[stages];
+
+                float subStage = 0.0f;
+                for (int i = 0; i < MAX_STAGES; i++)
+                {
+                    stageFactors.subStages[i/4][i % 4] = subStage;
+                    subStage -= stageFactors.invStages;
+                }
+            }
+        }
+
+        StageFactors factors[MAX_STAGES + 1];
+    };
 
-    int numStages = 2;
-    float invStages = 0.5;
-    float halfStages = 0.5f;
-    float remainInvStages = 0.5f;
-    float width = 0.5f;
-    float scan = 0.5f;
-    float slope = 0.5f;
-};
\ No newline at end of file
+    rack::simd::float_4 scanFinal = 0.0f;
+    rack::simd::float_4 invWidth = 1.0f;
+    rack::simd::float_4 slope = 0.0f;
+    const rack::simd::float_4* subStages[4] = {};
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "rack.hpp"
+#include <cstring>
+
+//Tables of random values that can be saved as a 64-bit seed plus the entries that changed since.
+//Entry i of a fresh table only depends on the seed and i, so the table regenerates exactly on load
+//and only the edits have to be stored.
+class HCVSeededTable
+{
+public:
+    //[0, 1) for entry _index, SplitMix64 with the index as the counter
+    static float generate(uint64_t _seed, uint32_t _index)
+    {
+        uint64_t z = _seed + (uint64_t(_index) + 1) * 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z = z ^ (z >> 31);
+
+        //24 bits, so the float is exact on every platform
+        return float(z >> 40) * (1.0f / 16777216.0f);
+    }
+
+    static void fill(uint64_t _seed, float* _table, int _size, float _scale)
+    {
+        for (int i = 0; i < _size; i++) _table[i] = generate(_seed, i) * _scale;
+    }
+
+    //Every entry that differs from the seeded table, as a 16-bit index and the raw float.
+    //Returns false when the edits would take more room than the table itself.
+    static bool encodeEdits(uint64_t _seed, const float* _table, int _size, float _scale, std::string& _edits)
+    {
+        std::vector<uint8_t> edits;
+        const size_t maxBytes = _size * sizeof(float);
+        for (int i = 0; i < _size; i++)
+        {
+            const float seeded = generate(_seed, i) * _scale;
+            if(std::memcmp(&seeded, &_table[i], sizeof(float)) == 0) continue;
+
+            uint8_t edit[EDIT_SIZE];
+            const uint16_t index = i;
+            std::memcpy(edit, &index, sizeof(index));
+            std::memcpy(edit + sizeof(index), &_table[i], sizeof(float));
+            edits.insert(edits.end(), edit, edit + EDIT_SIZE);
+
+            if(edits.size() >= maxBytes) return false;
+        }
+
+        _edits = rack::string::toBase64(edits.data(), edits.size());
+        return true;
+    }
+
+    //regenerates the table from _seed and applies the output of encodeEdits(). Malformed edits are skipped.
+    static void decode(uint64_t _seed, const char* _edits, float* _table, int _size, float _scale)
+    {
+        fill(_seed, _table, _size, _scale);
+        if(!_edits) return;
+
+        std::vector<uint8_t> edits;
+        try
+        {
+            edits = rack::string::fromBase64(_edits);
+        }
+        catch(rack::Exception&)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i + EDIT_SIZE <= edits.size(); i += EDIT_SIZE)
+        {
+            uint16_t index;
+            std::memcpy(&index, &edits[i], sizeof(index));
+            if(index < _size) std::memcpy(&_table[index], &edits[i + sizeof(index)], sizeof(float));
+        }
+    }
+
+private:
+    static constexpr int EDIT_SIZE = sizeof(uint16_t) + sizeof(float);
+};
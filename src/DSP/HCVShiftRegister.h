@@ -1,130 +1,262 @@
 #pragma once
 
 #include "dsp/digital.hpp"
-#include <vector>
 #include "HCVRandom.h"
 #include "HCVFunctions.h"
+#include "HCVGateLogic.h"
 
-template <typename T = float>
+//Fixed-size shift register of up to 64 stages packed into a single word.
+//Stage i is bit i, so advancing is a shift and a mask.
 class HCVShiftRegister
 {
 public:
-    HCVShiftRegister(int size = 8)
-    {
-        dataRegister.resize(size);
+    static constexpr int MAX_LENGTH = 64;
 
+    HCVShiftRegister(int _length = 8)
+    {
+        setLength(_length);
         emptyRegister();
     }
 
-    virtual void advanceRegister(T _input)
+    void setLength(int _length)
     {
-        for (auto i = dataRegister.size() - 1; i > 0; i--)
-        {
-            dataRegister[i] = dataRegister[i-1];
-        }
-
-        dataRegister[0] = _input;
+        length = std::max(1, std::min(int(MAX_LENGTH), _length));
+        lengthMask = length == 64 ? ~uint64_t(0) : ((uint64_t(1) << length) - 1);
+        dataRegister &= lengthMask;
     }
 
-    virtual void advanceRegisterFrozen()
+    int getLength() const { return length; }
+
+    void advanceRegister(bool _input)
     {
-        T temp = dataRegister[dataRegister.size() - 1];
+        dataRegister = ((dataRegister << 1) | uint64_t(_input)) & lengthMask;
+    }
 
-        for (auto i = dataRegister.size() - 1; i > 0; i--)
-        {
-            dataRegister[i] = dataRegister[i-1];
-        }
-        dataRegister[0] = temp;
+    //rotates the last stage back into the first
+    void advanceRegisterFrozen()
+    {
+        advanceRegister(getStage(length - 1));
     }
 
     void emptyRegister()
     {
-        for (size_t i = 0; i < dataRegister.size(); i++)
-        {
-           dataRegister[i] = T(0);
-        }
+        dataRegister = 0;
+    }
+
+    bool getStage(int _stage) const
+    {
+        return (dataRegister >> _stage) & 1;
+    }
+
+    //_numStages stages starting at _firstStage, read as an unsigned integer
+    uint64_t getStages(int _firstStage, int _numStages) const
+    {
+        return (dataRegister >> _firstStage) & ((uint64_t(1) << _numStages) - 1);
     }
 
-    std::vector<T> dataRegister;
+    uint64_t getBits() const { return dataRegister; }
+    void setBits(uint64_t _bits) { dataRegister = _bits & lengthMask; }
 
 private:
-    
+    uint64_t dataRegister = 0;
+    uint64_t lengthMask = 0xFF;
+    int length = 8;
 };
 
-class HCVRungler : public HCVShiftRegister<bool>
+//16 channels of Rungler shift register. Each channel is one 32-bit word and
+//the channels are shifted four at a time as int32_4 vectors.
+class HCVRunglerBank
 {
 public:
+    static constexpr int MAX_CHANNELS = 16;
+    static constexpr int MIN_LENGTH = 4;
+    static constexpr int MAX_LENGTH = 32;
 
-    virtual void advanceRegister(bool _input) override
+    HCVRunglerBank()
     {
-        for (int i = dataRegister.size() - 1; i > 0; i--)
-        {
-            dataRegister[i] = dataRegister[i-1];
-        }
+        setLength(8);
+        emptyRegister();
+    }
+
+    //also moves the DAC taps to the last three stages
+    void setLength(int _length)
+    {
+        length = std::max(int(MIN_LENGTH), std::min(int(MAX_LENGTH), _length));
+        lengthMask = length == 32 ? ~uint32_t(0) : ((uint32_t(1) << length) - 1);
+        for (int i = 0; i < NUM_BLOCKS; i++) words[i] &= rack::simd::int32_4(int32_t(lengthMask));
+        setTaps(length - 3, length - 2, length - 1);
+    }
+
+    int getLength() const { return length; }
 
-        if(xorMode) dataRegister[0] = (_input != dataRegister[dataRegister.size() - 1]);
-        else dataRegister[0] = _input;
-        calculateRunglerOut();
+    //stages read by the 3-bit DAC, from least to most significant
+    void setTaps(int _low, int _mid, int _high)
+    {
+        taps[0] = clampStage(_low);
+        taps[1] = clampStage(_mid);
+        taps[2] = clampStage(_high);
     }
 
-    void advanceRegisterFrozen() override
+    int getTap(int _index) const { return taps[_index]; }
+
+    void enableXORFeedback(bool _xorEnabled)
     {
-        for (int i = dataRegister.size() - 1; i > 0; i--)
+        xorMode = _xorEnabled;
+    }
+
+    //advances the channels whose bit is set in _clocks.
+    //Bit c of _data is written to channel c, or the register loops on itself when _frozen.
+    //Feedback comes from the second to last stage, like the original per-channel register.
+    void advance(uint32_t _clocks, uint32_t _data, bool _frozen)
+    {
+        using rack::simd::int32_4;
+        const int32_4 one = int32_4(1);
+        const int32_4 mask = int32_4(int32_t(lengthMask));
+        const int feedbackStage = length - 2;
+
+        for (int c = 0; c < MAX_CHANNELS; c += 4)
         {
-            dataRegister[i] = dataRegister[i-1];
+            if(((_clocks >> c) & 0xF) == 0) continue;
+
+            int32_4& word = words[c/4];
+            const int32_4 feedback = (word >> feedbackStage) & one;
+
+            int32_4 input;
+            if(_frozen) input = xorMode ? ((word & one) ^ feedback) : feedback;
+            else
+            {
+                const int32_4 data = int32_4::cast(HCVGateLogic::bitsToLanes(_data >> c)) & one;
+                input = xorMode ? (data ^ feedback) : data;
+            }
+
+            const int32_4 advanced = ((word << 1) | input) & mask;
+            const int32_4 clocked = int32_4::cast(HCVGateLogic::bitsToLanes(_clocks >> c));
+            word = rack::simd::ifelse(clocked, advanced, word);
         }
-        if(xorMode) dataRegister[0] = (dataRegister[0] != dataRegister[dataRegister.size() - 1]);
-        else dataRegister[0] = dataRegister[dataRegister.size() - 1];
-        calculateRunglerOut();
     }
 
-    void calculateRunglerOut()
+    void emptyRegister()
     {
-        float nextRungler = (dataRegister[5] ? 32.0f : 0.0f);
-		nextRungler = nextRungler + (dataRegister[6] ? 64.0f : 0.0f);
-		nextRungler = nextRungler + (dataRegister[7] ? 128.0f : 0.0f);
-		nextRungler = (nextRungler/255.0f);
-
-        runglerOut = nextRungler;
+        for (int i = 0; i < NUM_BLOCKS; i++) words[i] = rack::simd::int32_4(0);
     }
 
-    float getRunglerOut()
+    //5V gates for one stage of a four-channel block
+    rack::simd::float_4 getStageGates(int _firstChannel, int _stage, float _gateMagnitude = 5.0f) const
     {
-        return runglerOut;
+        using rack::simd::int32_4;
+        const int32_4 bits = (words[_firstChannel/4] >> _stage) & int32_4(1);
+        return rack::simd::ifelse(rack::simd::float_4::cast(bits == int32_4(1)), _gateMagnitude, 0.0f);
     }
 
-    void enableXORFeedback(bool _xorEnabled)
+    //3-bit DAC, in [0, 1]
+    rack::simd::float_4 getRunglerOut(int _firstChannel) const
     {
-        xorMode = _xorEnabled;
+        using rack::simd::int32_4;
+        const int32_4 word = words[_firstChannel/4];
+        const int32_4 one = int32_4(1);
+        const int32_4 level = (((word >> taps[0]) & one) << 5)
+                            + (((word >> taps[1]) & one) << 6)
+                            + (((word >> taps[2]) & one) << 7);
+        return rack::simd::float_4(level)/255.0f;
     }
 
+    uint32_t getRegister(int _channel) const { return uint32_t(words[_channel/4][_channel % 4]); }
+
 private:
-    float runglerOut = 0.0f;
+    static constexpr int NUM_BLOCKS = MAX_CHANNELS/4;
+
+    int clampStage(int _stage) const { return std::max(0, std::min(length - 1, _stage)); }
+
+    rack::simd::int32_4 words[NUM_BLOCKS] = {};
+    uint32_t lengthMask = 0xFF;
+    int length = 8;
+    int taps[3] = {5, 6, 7};
     bool xorMode = false;
 };
 
-class HCVLFSRNoise : public HCVShiftRegister<float>
+//Four maximal-length Fibonacci LFSRs, one per SIMD lane, stepped one bit per sample.
+//The noise value is the newest 8 stages, like an 8-bit shift register fed with random bits.
+class HCVLFSRNoise4
 {
 public:
-    float operator()()
+    struct Taps
     {
-        advanceRegister(randGen.nextBoolean());
+        int length;
+        uint32_t taps;
+    };
 
-        float noiseValue = dataRegister[0] ? 1.0f : 0.0f;
-        noiseValue += dataRegister[1] ? 2.0f : 0.0f;
-        noiseValue += dataRegister[2] ? 4.0f : 0.0f;
-        noiseValue += dataRegister[3] ? 8.0f : 0.0f;
-        noiseValue += dataRegister[4] ? 16.0f : 0.0f;
-        noiseValue += dataRegister[5] ? 32.0f : 0.0f;
-        noiseValue += dataRegister[6] ? 64.0f : 0.0f;
-        noiseValue += dataRegister[7] ? 128.0f : 0.0f;
+    static constexpr int NUM_TAPS = 7;
+    static constexpr int DEFAULT_TAPS = NUM_TAPS - 1;
 
-        noiseValue = noiseValue/255.0f;
-        noiseValue = uniToBi(noiseValue);
+    //maximal-length feedback taps, stage n is bit n-1
+    static Taps getTaps(int _index)
+    {
+        static const Taps taps[NUM_TAPS] = {
+            {9, 0x110},          //9, 5
+            {11, 0x500},         //11, 9
+            {15, 0x6000},        //15, 14
+            {16, 0xD008},        //16, 15, 13, 4
+            {23, 0x420000},      //23, 18
+            {31, 0x48000000},    //31, 28
+            {32, 0x80200003}     //32, 22, 2, 1
+        };
+        return taps[std::max(0, std::min(NUM_TAPS - 1, _index))];
+    }
 
-        return noiseValue;
+    HCVLFSRNoise4()
+    {
+        setTaps(DEFAULT_TAPS);
+    }
+
+    void setTaps(int _index)
+    {
+        tapIndex = std::max(0, std::min(NUM_TAPS - 1, _index));
+        const Taps taps = getTaps(tapIndex);
+        tapMask = _mm_set1_epi32(int32_t(taps.taps));
+        lengthMask = _mm_set1_epi32(int32_t(taps.length == 32 ? ~uint32_t(0) : ((uint32_t(1) << taps.length) - 1)));
+        seed(rack::random::u32());
+    }
+
+    int getTapIndex() const { return tapIndex; }
+
+    //an LFSR must never hold 0
+    void seed(uint32_t _seed)
+    {
+        uint32_t laneSeeds[4];
+        for (int i = 0; i < 4; i++)
+        {
+            _seed = _seed * 1664525u + 1013904223u;
+            laneSeeds[i] = _seed;
+        }
+
+        __m128i seeded = _mm_and_si128(_mm_loadu_si128((const __m128i*) laneSeeds), lengthMask);
+        const __m128i zero = _mm_cmpeq_epi32(seeded, _mm_setzero_si128());
+        state = _mm_or_si128(seeded, _mm_and_si128(zero, _mm_set1_epi32(1)));
+    }
+
+    //steps the lanes that are set in _mask and returns [-1, 1] for every lane
+    rack::simd::float_4 process(rack::simd::float_4 _mask)
+    {
+        //parity of the tapped stages
+        __m128i feedback = _mm_and_si128(state, tapMask);
+        feedback = _mm_xor_si128(feedback, _mm_srli_epi32(feedback, 16));
+        feedback = _mm_xor_si128(feedback, _mm_srli_epi32(feedback, 8));
+        feedback = _mm_xor_si128(feedback, _mm_srli_epi32(feedback, 4));
+        feedback = _mm_xor_si128(feedback, _mm_srli_epi32(feedback, 2));
+        feedback = _mm_xor_si128(feedback, _mm_srli_epi32(feedback, 1));
+        feedback = _mm_and_si128(feedback, _mm_set1_epi32(1));
+
+        const __m128i next = _mm_and_si128(_mm_or_si128(_mm_slli_epi32(state, 1), feedback), lengthMask);
+        const __m128i mask = _mm_castps_si128(_mask.v);
+        state = _mm_or_si128(_mm_and_si128(mask, next), _mm_andnot_si128(mask, state));
+
+        const rack::simd::float_4 noiseValue = rack::simd::float_4(_mm_cvtepi32_ps(_mm_and_si128(state, _mm_set1_epi32(0xFF))));
+        return uniToBi(noiseValue/255.0f);
     }
 
 private:
-    HCVRandom randGen;
-};
\ No newline at end of file
+    __m128i state;
+    __m128i tapMask;
+    __m128i lengthMask;
+    int tapIndex = DEFAULT_TAPS;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "rack.hpp"
+#include "HCVFunctions.h"
+
+//Vector trig functions for TrigShaper, four lanes at a time.
+//Inputs are limited to [-PI, PI] (and [-1, 1] for asin and acos), so short polynomials are enough.
+class HCVTrigShaper
+{
+public:
+    enum Functions { SINE, COSINE, TANGENT, NUM_FUNCTIONS };
+    enum Modes { REGULAR, HYPERBOLIC, ARC, NUM_MODES };
+    static constexpr int NUM_KERNELS = NUM_FUNCTIONS * NUM_MODES;
+
+    //_kernel is function * NUM_MODES + mode. _hardClipped is _input limited to [-1, 1].
+    static rack::simd::float_4 process(int _kernel, rack::simd::float_4 _input, rack::simd::float_4 _hardClipped)
+    {
+        switch (_kernel)
+        {
+            case SINE * NUM_MODES + REGULAR:        return sine(_input);
+            case SINE * NUM_MODES + HYPERBOLIC:     return hyperbolicSine(_input);
+            case SINE * NUM_MODES + ARC:            return arcSine(_hardClipped);
+            case COSINE * NUM_MODES + REGULAR:      return cosine(_input);
+            case COSINE * NUM_MODES + HYPERBOLIC:   return hyperbolicCosine(_input) - 2.0f;
+            case COSINE * NUM_MODES + ARC:          return arcCosine(_hardClipped);
+            case TANGENT * NUM_MODES + REGULAR:     return sine(_input)/cosine(_input);
+            case TANGENT * NUM_MODES + HYPERBOLIC:  return hyperbolicTangent(_input);
+            case TANGENT * NUM_MODES + ARC:         return arcTangent(_input);
+            default:                                return _input;
+        }
+    }
+
+    //x in [-PI, PI], folded to [-PI/2, PI/2] for a degree 11 Taylor series
+    static rack::simd::float_4 sine(rack::simd::float_4 _x)
+    {
+        _x = rack::simd::ifelse(_x > HALF_PI, PI - _x, _x);
+        _x = rack::simd::ifelse(_x < -HALF_PI, -PI - _x, _x);
+
+        const rack::simd::float_4 x2 = _x * _x;
+        return _x * (1.0f + x2 * (-1.0f/6.0f + x2 * (1.0f/120.0f + x2 * (-1.0f/5040.0f
+            + x2 * (1.0f/362880.0f + x2 * (-1.0f/39916800.0f))))));
+    }
+
+    static rack::simd::float_4 cosine(rack::simd::float_4 _x)
+    {
+        return sine(HALF_PI - rack::simd::fabs(_x));
+    }
+
+    static rack::simd::float_4 hyperbolicSine(rack::simd::float_4 _x)
+    {
+        const rack::simd::float_4 e = fastExp2(_x * 1.44269504089f);
+        return (e - 1.0f/e) * 0.5f;
+    }
+
+    static rack::simd::float_4 hyperbolicCosine(rack::simd::float_4 _x)
+    {
+        const rack::simd::float_4 e = fastExp2(_x * 1.44269504089f);
+        return (e + 1.0f/e) * 0.5f;
+    }
+
+    static rack::simd::float_4 hyperbolicTangent(rack::simd::float_4 _x)
+    {
+        const rack::simd::float_4 e2 = fastExp2(_x * (2.0f * 1.44269504089f));
+        return (e2 - 1.0f)/(e2 + 1.0f);
+    }
+
+    //x in [-1, 1]. Abramowitz and Stegun 4.4.46, error below 2e-8.
+    static rack::simd::float_4 arcCosine(rack::simd::float_4 _x)
+    {
+        const rack::simd::float_4 x = rack::simd::fabs(_x);
+        const rack::simd::float_4 poly = 1.5707963050f + x * (-0.2145988016f + x * (0.0889789874f + x * (-0.0501743046f
+            + x * (0.0308918810f + x * (-0.0170881256f + x * (0.0066700901f + x * -0.0012624911f))))));
+        const rack::simd::float_4 positive = rack::simd::sqrt(1.0f - x) * poly;
+
+        return rack::simd::ifelse(_x < 0.0f, PI - positive, positive);
+    }
+
+    static rack::simd::float_4 arcSine(rack::simd::float_4 _x)
+    {
+        return HALF_PI - arcCosine(_x);
+    }
+
+    static rack::simd::float_4 arcTangent(rack::simd::float_4 _x)
+    {
+        return fastArcTangent(_x);
+    }
+};
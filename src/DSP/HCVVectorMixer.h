@@ -0,0 +1,66 @@
+#pragma once
+
+#include "rack.hpp"
+#include "HCVFunctions.h"
+
+//Corner weights of a four input vector mixer, four channels at a time.
+//Every layout turns an X/Y position into one weight per corner, so the mixing itself is the same for all of them.
+class HCVVectorMixer
+{
+public:
+    enum Layouts
+    {
+        SQUARE_LAYOUT,      //bilinear across the corners of the X/Y square
+        RING4_LAYOUT,       //A, B, D, C around a ring, crossfaded by angle
+        RING8_LAYOUT,       //the same ring with every corner repeated, so one turn passes each corner twice
+        NUM_LAYOUTS
+    };
+
+    enum Corners { CORNER_A, CORNER_B, CORNER_C, CORNER_D, NUM_CORNERS };
+
+    static std::vector<std::string> getLabels()
+    {
+        return {"XY Square", "4 Point Ring", "8 Point Ring"};
+    }
+
+    //_x and _y in [0, 1]. The weights always sum to 1.
+    static void getWeights(int _layout, rack::simd::float_4 _x, rack::simd::float_4 _y, rack::simd::float_4* _weights)
+    {
+        if(_layout == SQUARE_LAYOUT)
+        {
+            _weights[CORNER_A] = (1.0f - _x) * (1.0f - _y);
+            _weights[CORNER_B] = _x * (1.0f - _y);
+            _weights[CORNER_C] = (1.0f - _x) * _y;
+            _weights[CORNER_D] = _x * _y;
+            return;
+        }
+
+        getRingWeights(_layout == RING8_LAYOUT ? 8 : 4, _x, _y, _weights);
+    }
+
+private:
+    //Points sit on a ring through the corners of the square, starting at A. The angle around the center
+    //crossfades between neighboring points, and the distance from the center fades from an even mix to the ring.
+    static void getRingWeights(int _numPoints, rack::simd::float_4 _x, rack::simd::float_4 _y, rack::simd::float_4* _weights)
+    {
+        using rack::simd::float_4;
+        static const int ringOrder[NUM_CORNERS] = {CORNER_A, CORNER_B, CORNER_D, CORNER_C};
+
+        const float_4 dx = _x * 2.0f - 1.0f;
+        const float_4 dy = _y * 2.0f - 1.0f;
+        const float_4 radius = rack::simd::fmin(rack::simd::sqrt(dx * dx + dy * dy), 1.0f);
+
+        //A is at -3/8 of a turn
+        float_4 position = (fastArcTangent2(dy, dx) * (1.0f/TWO_PI) + 0.375f) * float(_numPoints);
+        position = rack::simd::ifelse(position < 0.0f, position + float(_numPoints), position);
+
+        for (int i = 0; i < NUM_CORNERS; i++) _weights[i] = (1.0f - radius) * 0.25f;
+
+        for (int point = 0; point < _numPoints; point++)
+        {
+            float_4 distance = rack::simd::fabs(position - float(point));
+            distance = rack::simd::fmin(distance, float(_numPoints) - distance);
+            _weights[ringOrder[point % NUM_CORNERS]] += radius * rack::simd::fmax(1.0f - distance, 0.0f);
+        }
+    }
+};
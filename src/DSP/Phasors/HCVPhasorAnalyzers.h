@@ -5,6 +5,7 @@
 #include "Gamma/Domain.h"
 #include "Gamma/scl.h"
 #include "dsp/digital.hpp"
+#include "simd/functions.hpp"
 
 class HCVPhasorSlopeDetector
 {
@@ -81,6 +82,44 @@ private:
     rack::dsp::BooleanTrigger repeatFilter;
 };
 
+//four-channel version of HCVPhasorResetDetector::detectProportionalReset()
+//returns a mask that is set for each channel where a reset was detected
+class HCVPhasorResetDetector4
+{
+public:
+    rack::simd::float_4 detectProportionalReset(rack::simd::float_4 _normalizedPhasorIn)
+    {
+        const rack::simd::float_4 difference = _normalizedPhasorIn - lastSamples;
+        const rack::simd::float_4 sum = _normalizedPhasorIn + lastSamples;
+        lastSamples = _normalizedPhasorIn;
+
+        //channels with a sum of 0 are ignored and leave the repeat filter untouched
+        const rack::simd::float_4 validSum = sum != 0.0f;
+        const rack::simd::float_4 resetDetected = validSum & (rack::simd::fabs(difference/sum) > threshold);
+
+        const rack::simd::float_4 triggered = resetDetected & ~repeatFilter;
+        repeatFilter = rack::simd::ifelse(validSum, resetDetected, repeatFilter);
+        return triggered;
+    }
+
+    //keeps the detector in sync with its input while detection is not needed
+    void skipDetection(rack::simd::float_4 _normalizedPhasorIn)
+    {
+        lastSamples = _normalizedPhasorIn;
+        repeatFilter = rack::simd::float_4::mask();
+    }
+
+    void setThreshold(float _threshold)
+    {
+        threshold = clamp(_threshold, 0.0f, 1.0f);
+    }
+
+private:
+    rack::simd::float_4 lastSamples = 0.0f;
+    rack::simd::float_4 repeatFilter = rack::simd::float_4::mask();
+    float threshold = 0.5f;
+};
+
 class HCVPhasorStepDetector
 {
 public:
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "Gamma/scl.h"
+#include "simd/functions.hpp"
 
 static constexpr float HCV_PHZ_UPSCALE = 10.0f;
 static constexpr float HCV_PHZ_DOWNSCALE = 0.1f;
@@ -10,4 +11,12 @@ static constexpr float HCV_PHZ_GATESCALE = 10.0f;
 static float scaleAndWrapPhasor(float _input)
 {
     return gam::scl::wrap(_input * HCV_PHZ_DOWNSCALE);
-}
\ No newline at end of file
+}
+
+static rack::simd::float_4 scaleAndWrapPhasor(rack::simd::float_4 _input)
+{
+    const rack::simd::float_4 scaled = _input * HCV_PHZ_DOWNSCALE;
+
+    //gam::scl::wrap never returns the upper bound, so tiny negative inputs stay just below 1.0
+    return rack::simd::fmin(scaled - rack::simd::floor(scaled), 0.99999994f);
+}
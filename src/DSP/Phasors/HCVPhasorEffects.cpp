@@ -73,12 +73,10 @@ float HCVPhasorFreezer::operator()(float _normalizedPhasorIn, bool _frozen)
 
 void HCVPhasorToEuclidean::processPhasor(float _normalizedPhasor)
 {
-    float scaledRotation = quantizeRotation ? floorf(rotation * steps)/steps : rotation;
     const float scaledRamp = gam::scl::wrap(_normalizedPhasor + scaledRotation) * steps;
-    const float stepWidth = scaledRamp - floorf(scaledRamp);
-    clockOutput = clockGateDetector(stepWidth);
-
     const float currentStep = floorf(scaledRamp);
+    clockOutput = clockGateDetector(scaledRamp - currentStep);
+
     if(stepDetector(_normalizedPhasor) || !quantizeParameterChanges)
     {
         lastStep = currentStep;
@@ -86,6 +84,7 @@ void HCVPhasorToEuclidean::processPhasor(float _normalizedPhasor)
         fill = pendingFill;
         rotation = pendingRotation;
         stepDetector.setNumberSteps(steps);
+        updatePattern();
     }
 
     if(fill == 0.0f)
@@ -95,35 +94,64 @@ void HCVPhasorToEuclidean::processPhasor(float _normalizedPhasor)
         return;
     }
 
-    if(fill > steps)
+    const int stepIndex = (int)currentStep;
+    float eventStart, eventScale;
+    if(stepIndex >= 0 && stepIndex < cachedSteps)
     {
+        eventStart = eventStarts[stepIndex];
+        eventScale = eventScales[stepIndex];
+    }
+    else calculateEvent(currentStep, eventStart, eventScale); //only reachable on the sample where steps shrink
 
-        const float fillRatio = fill/steps;
-        const float ratchetLevel = ceilf(fill/steps);
-        const float ratchetDepth = exp2(ratchetLevel - 1.0f);
+    phasorOutput = (scaledRamp - eventStart) * eventScale;
+    if(ratchetMode) phasorOutput = gam::scl::wrap(phasorOutput);
 
-        const float previousEvent = floorf(currentStep * fillRatio);
-        const float nextEvent = ceilf((previousEvent + ratchetLevel)/fillRatio);
-        const float currentEvent = ceilf(previousEvent/fillRatio);
+    euclidGateOutput = euclidGateDetector(phasorOutput);
+}
 
-        const float lengthBeats = nextEvent - currentEvent;
+void HCVPhasorToEuclidean::updatePattern()
+{
+    updateRotation();
 
-        phasorOutput = gam::scl::wrap((scaledRamp - currentEvent)/lengthBeats * ratchetDepth);
-        euclidGateOutput = euclidGateDetector(phasorOutput);
+    if(steps == cachedStepCount && fill == cachedFill) return;
+    cachedStepCount = steps;
+    cachedFill = fill;
 
+    ratchetMode = fill > steps;
+    if(fill == 0.0f)
+    {
+        cachedSteps = 0;
         return;
     }
 
+    cachedSteps = std::min(int(MAX_CACHED_STEPS), (int)ceilf(steps));
+    for (int i = 0; i < cachedSteps; i++)
+    {
+        calculateEvent(i, eventStarts[i], eventScales[i]);
+    }
+}
+
+void HCVPhasorToEuclidean::updateRotation()
+{
+    scaledRotation = quantizeRotation ? floorf(rotation * steps)/steps : rotation;
+}
+
+void HCVPhasorToEuclidean::calculateEvent(float _step, float& _eventStart, float& _eventScale) const
+{
     const float fillRatio = fill/steps;
 
-    const float previousEvent = floorf(currentStep * fillRatio);
-    const float nextEvent = ceilf((previousEvent + 1.0f)/fillRatio);
+    //in ratchet mode, events repeat ratchetDepth times within each Euclidean beat
+    const float ratchetLevel = ratchetMode ? ceilf(fillRatio) : 1.0f;
+    const float ratchetDepth = ratchetMode ? exp2f(ratchetLevel - 1.0f) : 1.0f;
+
+    const float previousEvent = floorf(_step * fillRatio);
+    const float nextEvent = ceilf((previousEvent + ratchetLevel)/fillRatio);
     const float currentEvent = ceilf(previousEvent/fillRatio);
 
     const float lengthBeats = nextEvent - currentEvent;
 
-    phasorOutput = ((scaledRamp - currentEvent)/lengthBeats);
-    euclidGateOutput = euclidGateDetector(phasorOutput);
+    _eventStart = currentEvent;
+    _eventScale = ratchetDepth/lengthBeats;
 }
 
 
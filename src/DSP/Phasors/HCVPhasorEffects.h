@@ -62,6 +62,94 @@ protected:
     bool waitingToSync = false;
 };
 
+//Runs a bank of phasor dividers/multipliers that share one slope analysis per channel.
+//This is equivalent to running HCVPhasorDivMult::basicSync() once per ratio,
+//but the slope is only calculated once and each ratio's channels are stored contiguously.
+template <int NUM_RATIOS>
+class HCVPhasorRatioBank
+{
+public:
+    static constexpr int MAX_CHANNELS = 16;
+
+    HCVPhasorRatioBank()
+    {
+        for (int ratio = 0; ratio < NUM_RATIOS; ratio++)
+        {
+            for (int chan = 0; chan < MAX_CHANNELS; chan++)
+            {
+                speedScales[ratio][chan] = 1.0;
+                phases[ratio][chan] = 0.0;
+            }
+        }
+    }
+
+    void setRatio(int _ratio, int _channel, float _multiplier, float _divider)
+    {
+        speedScales[_ratio][_channel] = double(std::max(0.0001f, _multiplier))/double(std::max(0.0001f, _divider));
+    }
+
+    void setRatio(int _ratio, float _multiplier, float _divider)
+    {
+        for (int chan = 0; chan < MAX_CHANNELS; chan++)
+        {
+            setRatio(_ratio, chan, _multiplier, _divider);
+        }
+    }
+
+    void reset(int _ratio, int _channel, float _resetPhase = 0.0f)
+    {
+        phases[_ratio][_channel] = _resetPhase;
+    }
+
+    void resetChannel(int _channel, float _resetPhase = 0.0f)
+    {
+        for (int ratio = 0; ratio < NUM_RATIOS; ratio++)
+        {
+            phases[ratio][_channel] = _resetPhase;
+        }
+    }
+
+    //analyzes four channels starting at _firstChannel and advances every ratio for them
+    void process(int _firstChannel, rack::simd::float_4 _normalizedPhasors)
+    {
+        rack::simd::float_4 slope = _normalizedPhasors - rack::simd::float_4::load(&lastSamples[_firstChannel]);
+        slope -= rack::simd::floor(slope + 0.5f); //same as gam::scl::wrap(slope, 0.5f, -0.5f)
+
+        _normalizedPhasors.store(&lastSamples[_firstChannel]);
+        slope.store(&slopes[_firstChannel]);
+
+        for (int ratio = 0; ratio < NUM_RATIOS; ratio++)
+        {
+            double* phase = &phases[ratio][_firstChannel];
+            const double* speedScale = &speedScales[ratio][_firstChannel];
+            const float* channelSlope = &slopes[_firstChannel];
+
+            for (int i = 0; i < 4; i++)
+            {
+                const double nextPhase = phase[i] + double(channelSlope[i]) * speedScale[i];
+                phase[i] = nextPhase - std::floor(nextPhase);
+            }
+        }
+    }
+
+    float getPhase(int _ratio, int _channel) const
+    {
+        return phases[_ratio][_channel];
+    }
+
+    rack::simd::float_4 getPhases(int _ratio, int _firstChannel) const
+    {
+        const double* phase = &phases[_ratio][_firstChannel];
+        return rack::simd::float_4(phase[0], phase[1], phase[2], phase[3]);
+    }
+
+protected:
+    alignas(16) float lastSamples[MAX_CHANNELS] = {};
+    alignas(16) float slopes[MAX_CHANNELS] = {};
+    alignas(16) double phases[NUM_RATIOS][MAX_CHANNELS];
+    alignas(16) double speedScales[NUM_RATIOS][MAX_CHANNELS];
+};
+
 class HCVPhasorFreezer
 {
 public:
@@ -85,6 +173,7 @@ public:
     HCVPhasorToEuclidean()
     {
         stepDetector.setNumberSteps(steps);
+        updatePattern();
     }
 
     void processPhasor(float _normalizedPhasor);
@@ -128,10 +217,27 @@ public:
 
     void setRotationQuantization(bool _quantizationEnabled)
     {
+        if(quantizeRotation == _quantizationEnabled) return;
         quantizeRotation = _quantizationEnabled;
+        updateRotation();
     }
 
+    static constexpr int MAX_CACHED_STEPS = 64;
+
 protected:
+    //the pattern only changes when steps, fill, or rotation are committed,
+    //so each step's event start and phasor scale are cached here
+    void updatePattern();
+    void updateRotation();
+    void calculateEvent(float _step, float& _eventStart, float& _eventScale) const;
+
+    float eventStarts[MAX_CACHED_STEPS];
+    float eventScales[MAX_CACHED_STEPS];
+    int cachedSteps = 0;
+    float cachedStepCount = -1.0f, cachedFill = -1.0f;
+    float scaledRotation = 0.0f;
+    bool ratchetMode = false;
+
     float pulseWidth = 0.5f;
 
     //these are traditionally ints, but we use floats for calculations
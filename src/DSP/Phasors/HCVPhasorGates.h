@@ -0,0 +1,194 @@
+#pragma once
+
+#include "rack.hpp"
+#include "HCVPhasorCommon.h"
+
+//Step pattern for the Phasor Gates family, stored as a single bitset.
+//Step i is on when bit i is set.
+template <int NUM_STEPS>
+class HCVGatePattern
+{
+public:
+    static_assert(NUM_STEPS > 0 && NUM_STEPS <= 64, "HCVGatePattern supports up to 64 steps");
+
+    bool get(int _step) const
+    {
+        return (bits >> _step) & 1;
+    }
+
+    void set(int _step, bool _on)
+    {
+        const uint64_t stepBit = uint64_t(1) << _step;
+        bits = _on ? (bits | stepBit) : (bits & ~stepBit);
+    }
+
+    void toggle(int _step)
+    {
+        bits ^= uint64_t(1) << _step;
+    }
+
+    //toggles every step whose bit is set in _steps
+    void toggleSteps(uint64_t _steps)
+    {
+        bits ^= _steps & ALL_STEPS;
+    }
+
+    void clear()
+    {
+        bits = 0;
+    }
+
+    void randomize()
+    {
+        bits = 0;
+        for (int i = 0; i < NUM_STEPS; i++)
+        {
+            if(rack::random::get<bool>()) bits |= uint64_t(1) << i;
+        }
+    }
+
+    uint64_t getBits() const { return bits; }
+    void setBits(uint64_t _bits) { bits = _bits & ALL_STEPS; }
+
+    //returns a mask that is set for each lane whose step is on
+    rack::simd::float_4 getStepMask(const rack::simd::float_4& _steps) const
+    {
+        const rack::simd::float_4 stepBits = rack::simd::float_4(
+            get(int(_steps[0])) ? 1.0f : 0.0f,
+            get(int(_steps[1])) ? 1.0f : 0.0f,
+            get(int(_steps[2])) ? 1.0f : 0.0f,
+            get(int(_steps[3])) ? 1.0f : 0.0f);
+
+        return stepBits != 0.0f;
+    }
+
+    //stored as an array of booleans so existing patches keep loading
+    json_t* toJson() const
+    {
+        json_t *gateStatesJ = json_array();
+        for (int i = 0; i < NUM_STEPS; i++)
+        {
+            json_array_append_new(gateStatesJ, json_boolean(get(i)));
+        }
+        return gateStatesJ;
+    }
+
+    //also reads a single hexadecimal word, bit i for step i
+    void fromJson(json_t* _gateStatesJ)
+    {
+        if(!_gateStatesJ) return;
+
+        if(json_is_string(_gateStatesJ))
+        {
+            setBits(std::strtoull(json_string_value(_gateStatesJ), nullptr, 16));
+            return;
+        }
+
+        for (int i = 0; i < NUM_STEPS; i++)
+        {
+            json_t *stateJ = json_array_get(_gateStatesJ, i);
+            if (stateJ) set(i, json_boolean_value(stateJ));
+        }
+    }
+
+private:
+    static constexpr uint64_t ALL_STEPS = NUM_STEPS == 64 ? ~uint64_t(0) : ((uint64_t(1) << (NUM_STEPS % 64)) - 1);
+    uint64_t bits = 0;
+};
+
+//Shared engine for PhasorGates, PhasorGates32 and PhasorGates64.
+//Processes four channels at a time. Only the gate lookup is done per lane.
+template <int NUM_STEPS>
+class HCVPhasorGateSequencer
+{
+public:
+    static constexpr int MAX_CHANNELS = 16;
+
+    void process(int _firstChannel, rack::simd::float_4 _normalizedPhasors,
+                rack::simd::float_4 _numSteps, rack::simd::float_4 _pulseWidths,
+                rack::simd::float_4 _active, float _sampleTime)
+    {
+        using rack::simd::float_4;
+        const int block = _firstChannel/4;
+
+        //matches HCVPhasorStepDetector, which truncates the number of steps (always at least 1)
+        const float_4 numberSteps = rack::simd::fmax(rack::simd::floor(_numSteps), 1.0f);
+        const float_4 scaledPhasors = _normalizedPhasors * numberSteps;
+        const float_4 stepIndices = rack::simd::fmin(rack::simd::floor(scaledPhasors), float(NUM_STEPS - 1));
+        const float_4 fractionalSteps = scaledPhasors - rack::simd::floor(scaledPhasors);
+
+        const float_4 stepsOn = pattern.getStepMask(stepIndices);
+
+        float_4 visible, fractionalOutputs, outputActive;
+        if(smartDetection)
+        {
+            //slopes are only tracked in smart mode, like HCVPhasorSlopeDetector in the original modules
+            const float_4 difference = _normalizedPhasors - lastPhasors[block];
+            lastPhasors[block] = _normalizedPhasors;
+            advancing[block] = difference != 0.0f;
+
+            //sign of the difference wrapped to [-0.5, 0.5)
+            const float_4 reverse = ((difference < 0.0f) & (difference >= -0.5f)) | (difference >= 0.5f);
+
+            visible = advancing[block] | (_normalizedPhasors != 0.0f);
+            fractionalOutputs = rack::simd::ifelse(reverse, 1.0f - fractionalSteps, fractionalSteps);
+            outputActive = float_4::mask();
+        }
+        else
+        {
+            visible = float_4::mask();
+            fractionalOutputs = fractionalSteps;
+            outputActive = _active;
+        }
+
+        const float_4 gateOn = fractionalOutputs < _pulseWidths;
+        const float_4 visibleGates = visible & gateOn & outputActive;
+
+        gates[block] = rack::simd::ifelse(visibleGates & stepsOn, HCV_PHZ_GATESCALE, 0.0f);
+        inverseGates[block] = rack::simd::ifelse(visibleGates & ~stepsOn, HCV_PHZ_GATESCALE, 0.0f);
+        phasors[block] = rack::simd::ifelse(visible & stepsOn, fractionalOutputs * HCV_PHZ_UPSCALE, 0.0f);
+
+        //equivalent to HCVTriggeredGate, but lanes that aren't visible keep their state
+        const float_4 triggerIn = gateOn & stepsOn;
+        const float_4 rising = visible & triggerIn & ~lastTriggers[block];
+        lastTriggers[block] = rack::simd::ifelse(visible, triggerIn, lastTriggers[block]);
+
+        float_4& remaining = triggerTimes[block];
+        remaining = rack::simd::ifelse(rising & (gateLengthInSeconds > remaining), gateLengthInSeconds, remaining);
+        const float_4 triggerHigh = visible & (remaining > 0.0f);
+        remaining = rack::simd::ifelse(triggerHigh, remaining - _sampleTime, remaining);
+        triggers[block] = rack::simd::ifelse(triggerHigh, HCV_PHZ_GATESCALE, 0.0f);
+
+        if(block == 0) firstStep = int(stepIndices[0]);
+    }
+
+    void setSmartDetection(bool _smartDetection) { smartDetection = _smartDetection; }
+
+    rack::simd::float_4 getGates(int _firstChannel) const { return gates[_firstChannel/4]; }
+    rack::simd::float_4 getInverseGates(int _firstChannel) const { return inverseGates[_firstChannel/4]; }
+    rack::simd::float_4 getTriggers(int _firstChannel) const { return triggers[_firstChannel/4]; }
+    rack::simd::float_4 getPhasors(int _firstChannel) const { return phasors[_firstChannel/4]; }
+
+    //step and playback state of the first channel, used for the step lights
+    int getFirstChannelStep() const { return firstStep; }
+    bool isFirstChannelAdvancing() const { return rack::simd::movemask(advancing[0]) & 1; }
+
+    HCVGatePattern<NUM_STEPS> pattern;
+
+private:
+    static constexpr int NUM_BLOCKS = MAX_CHANNELS/4;
+
+    bool smartDetection = true;
+    float gateLengthInSeconds = 0.001f;
+    int firstStep = 0;
+
+    rack::simd::float_4 lastPhasors[NUM_BLOCKS] = {};
+    rack::simd::float_4 advancing[NUM_BLOCKS] = {};
+    rack::simd::float_4 lastTriggers[NUM_BLOCKS] = {rack::simd::float_4::mask(), rack::simd::float_4::mask(), rack::simd::float_4::mask(), rack::simd::float_4::mask()};
+    rack::simd::float_4 triggerTimes[NUM_BLOCKS] = {};
+
+    rack::simd::float_4 gates[NUM_BLOCKS] = {};
+    rack::simd::float_4 inverseGates[NUM_BLOCKS] = {};
+    rack::simd::float_4 triggers[NUM_BLOCKS] = {};
+    rack::simd::float_4 phasors[NUM_BLOCKS] = {};
+};
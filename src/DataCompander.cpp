@@ -44,14 +44,10 @@ struct DataCompander : HCVModule
 	}
 
 	void process(const ProcessArgs &args) override;
-
-    simd::float_4   compInsL[4] = {0.0f, 0.0f, 0.0f, 0.0f}, compInsR[4] = {0.0f, 0.0f, 0.0f, 0.0f},
-                    expInsL[4] = {0.0f, 0.0f, 0.0f, 0.0f}, expInsR[4] = {0.0f, 0.0f, 0.0f, 0.0f},
-                    compOutsL[4] = {0.0f, 0.0f, 0.0f, 0.0f}, compOutsR[4] = {0.0f, 0.0f, 0.0f, 0.0f},
-                    expOutsL[4] = {0.0f, 0.0f, 0.0f, 0.0f}, expOutsR[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    void processSide(int _compInput, int _compOutput, int _expInput, int _expOutput, int _channels);
 
     const float mu = 255.0f;
-    const float logMu1 = log(mu + 1.0f);
+    const float log2Mu1 = std::log2(mu + 1.0f);
     const float recipMu = 1.0f/mu;
 
     const float A = 87.6f;
@@ -59,52 +55,35 @@ struct DataCompander : HCVModule
     const float logA = log(A);
     const float aExpansionCompare = (1.0f/(1.0f + logA));
 
+    // The companding curves below are branch-free: both segments are computed and the mask picks one.
     simd::float_4 aLawCompression(simd::float_4 _input)
     {
-        simd::float_4 absx = fabs(_input);
+        const simd::float_4 absx = fabs(_input);
 
-        for (int i = 0; i < 4; i++)
-        {
-            if (absx[i] < recipA)
-            {
-                _input[i] = fabs((A * absx[i]) / (1 + logA)) * sgn(_input[i]);
-            }
-            else
-            {
-                _input[i] = fabs((1 + log(A * absx[i])) / (1 + logA)) * sgn(_input[i]);
-            }
-        }
-        
-        return _input;
+        const simd::float_4 linear = (A * absx) / (1.0f + logA);
+        const simd::float_4 logarithmic = (1.0f + fastLog2(A * absx) * 0.69314718056f) / (1.0f + logA);
+
+        return simd::ifelse(absx < recipA, linear, logarithmic) * sgn(_input);
     }
 
     simd::float_4 muLawCompression(simd::float_4 _input)
     {
-        return fabs((log(1.0f + mu * fabs(_input))) / logMu1) * sgn(_input);
+        return (fastLog2(1.0f + mu * fabs(_input)) / log2Mu1) * sgn(_input);
     }
 
     simd::float_4 aLawExpansion(simd::float_4 _input)
     {
-        simd::float_4 absy = fabs(_input);
+        const simd::float_4 absy = fabs(_input);
 
-        for (int i = 0; i < 4; i++)
-        {
-            if (absy[i] < aExpansionCompare)
-            {
-                _input[i] = fabs((absy[i] * (1.0f + logA)) / A) * sgn(_input[i]);
-            }
-            else
-            {
-                _input[i] = fabs(exp(absy[i] * (1.0f + logA) - 1.0f) / A) * sgn(_input[i]);
-            }
-        }
+        const simd::float_4 linear = (absy * (1.0f + logA)) / A;
+        const simd::float_4 exponential = fastExp2((absy * (1.0f + logA) - 1.0f) * 1.44269504089f) / A;
 
-        return _input;
+        return simd::ifelse(absy < aExpansionCompare, linear, exponential) * sgn(_input);
     }
 
     simd::float_4 muLawExpansion(simd::float_4 _input)
     {
-        return fabs(recipMu * (pow(1.0 + mu, fabs(_input)) - 1.0f)) * sgn(_input);
+        return (recipMu * (fastExp2(log2Mu1 * fabs(_input)) - 1.0f)) * sgn(_input);
     }
 
     simd::float_4 compress(simd::float_4 _input)
@@ -184,46 +163,38 @@ void DataCompander::process(const ProcessArgs &args)
 	}
 
     int channels = getMaxInputPolyphony();
-    outputs[COMP_OUTL_OUTPUT].setChannels(channels);
-    outputs[COMP_OUTR_OUTPUT].setChannels(channels);
-    outputs[EXP_OUTL_OUTPUT].setChannels(channels);
-    outputs[EXP_OUTR_OUTPUT].setChannels(channels);
-
-    bool expLConnected = inputs[EXP_INL_INPUT].isConnected();
-    bool expRConnected = inputs[EXP_INR_INPUT].isConnected();
 
     expMode = params[EXP_MODE_PARAM].getValue();
     compMode = params[COMP_MODE_PARAM].getValue();
 
-	for (int c = 0; c < channels; c += 4) 
-	{
-        const int vectorIndex = c / 4;
-
-        ////compression
-		compInsL[vectorIndex] = simd::float_4::load(inputs[COMP_INL_INPUT].getVoltages(c));
-        compInsR[vectorIndex] = simd::float_4::load(inputs[COMP_INR_INPUT].getVoltages(c));
+    processSide(COMP_INL_INPUT, COMP_OUTL_OUTPUT, EXP_INL_INPUT, EXP_OUTL_OUTPUT, channels);
+    processSide(COMP_INR_INPUT, COMP_OUTR_OUTPUT, EXP_INR_INPUT, EXP_OUTR_OUTPUT, channels);
+}
 
-        compInsL[vectorIndex] = clamp(compInsL[vectorIndex] * compDownscale, -1.0f, 1.0f);
-        compInsR[vectorIndex] = clamp(compInsR[vectorIndex] * compDownscale, -1.0f, 1.0f);
+//one compressor and expander pair, all channels four at a time
+void DataCompander::processSide(int _compInput, int _compOutput, int _expInput, int _expOutput, int _channels)
+{
+    outputs[_compOutput].setChannels(_channels);
+    outputs[_expOutput].setChannels(_channels);
 
-        compOutsL[vectorIndex] = compress(compInsL[vectorIndex]) * compUpscale;
-        compOutsR[vectorIndex] = compress(compInsR[vectorIndex]) * compUpscale;
+    const bool expConnected = inputs[_expInput].isConnected();
 
-        ////expansion
+	for (int c = 0; c < _channels; c += 4) 
+	{
+        ////compression
+        simd::float_4 compIns = simd::float_4::load(inputs[_compInput].getVoltages(c));
+        compIns = clamp(compIns * compDownscale, -1.0f, 1.0f);
 
-        expInsL[vectorIndex] = expLConnected ? simd::float_4::load(inputs[EXP_INL_INPUT].getVoltages(c)) : compOutsL[vectorIndex];
-        expInsR[vectorIndex] = expRConnected ? simd::float_4::load(inputs[EXP_INR_INPUT].getVoltages(c)) : compOutsR[vectorIndex];
+        simd::float_4 compOuts = compress(compIns) * compUpscale;
 
-        expInsL[vectorIndex] = clamp(expInsL[vectorIndex] * expDownscale, -1.0f, 1.0f);
-        expInsR[vectorIndex] = clamp(expInsR[vectorIndex] * expDownscale, -1.0f, 1.0f);
+        ////expansion
+        simd::float_4 expIns = expConnected ? simd::float_4::load(inputs[_expInput].getVoltages(c)) : compOuts;
+        expIns = clamp(expIns * expDownscale, -1.0f, 1.0f);
 
-        expOutsL[vectorIndex] = expand(expInsL[vectorIndex]) * expUpscale;
-        expOutsR[vectorIndex] = expand(expInsR[vectorIndex]) * expUpscale;
+        simd::float_4 expOuts = expand(expIns) * expUpscale;
 
-        compOutsL[vectorIndex].store(outputs[COMP_OUTL_OUTPUT].getVoltages(c));
-        compOutsR[vectorIndex].store(outputs[COMP_OUTR_OUTPUT].getVoltages(c));
-        expOutsL[vectorIndex].store(outputs[EXP_OUTL_OUTPUT].getVoltages(c));
-        expOutsR[vectorIndex].store(outputs[EXP_OUTR_OUTPUT].getVoltages(c));
+        compOuts.store(outputs[_compOutput].getVoltages(c));
+        expOuts.store(outputs[_expOutput].getVoltages(c));
 	}
 }
 
@@ -1,4 +1,6 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVDataConverter.h"
+#include "DSP/HCVGateLogic.h"
 
 struct DigitalToAnalog : HCVModule
 {
@@ -57,16 +59,16 @@ struct DigitalToAnalog : HCVModule
 		NUM_LIGHTS
     };
 
-    dsp::SchmittTrigger clockTrigger;
+    HCVSchmittBank clockTriggers;
     dsp::SchmittTrigger modeTrigger;
     dsp::SchmittTrigger rectTrigger;
 
     int mode = 0;
     int rectMode = 0;
+    int bitDepth = 8;
 
-    float mainOutput = 0.0f;
-
-    bool ins[8] = {};
+    //the last converted voltage of each channel, held between sync pulses
+    simd::float_4 mainOutputs[4] = {};
 
 	DigitalToAnalog()
 	{
@@ -89,14 +91,11 @@ struct DigitalToAnalog : HCVModule
 
     void process(const ProcessArgs &args) override;
 
-    void processUni8();
-    void processBiOff();
-    void processBiSig();
-
     void onReset() override
     {
         mode = 0;
         rectMode = 0;
+        bitDepth = 8;
 	}
     void onRandomize() override
     {
@@ -109,6 +108,7 @@ struct DigitalToAnalog : HCVModule
 		json_t *rootJ = json_object();
         json_object_set_new(rootJ, "mode", json_integer(mode));
         json_object_set_new(rootJ, "rectMode", json_integer(rectMode));
+        json_object_set_new(rootJ, "bitDepth", json_integer(bitDepth));
 		return rootJ;
 	}
     void dataFromJson(json_t *rootJ) override
@@ -120,6 +120,10 @@ struct DigitalToAnalog : HCVModule
         json_t *rectModeJ = json_object_get(rootJ, "rectMode");
         if (rectModeJ)
             rectMode = json_integer_value(rectModeJ);
+
+        json_t *bitDepthJ = json_object_get(rootJ, "bitDepth");
+        if (bitDepthJ)
+            bitDepth = clamp(int(json_integer_value(bitDepthJ)), 1, HCVDataConverter::MAX_BITS);
 	}
 
 	// For more advanced Module features, read Rack's engine.hpp header file
@@ -142,91 +146,90 @@ void DigitalToAnalog::process(const ProcessArgs &args)
     lights[RECT_HALF_LIGHT].setBrightness(rectMode == 1 ? 1.0f : 0.0f);
     lights[RECT_FULL_LIGHT].setBrightness(rectMode == 2 ? 1.0f : 0.0f);
 
-    const bool syncModeEnabled = inputs[SYNC_INPUT].isConnected();
-    const bool readyForProcess = (!syncModeEnabled || (syncModeEnabled && clockTrigger.process(inputs[SYNC_INPUT].getVoltage())));
-
-    if(readyForProcess)
+    //polyphony follows the bit jacks. The poly jack holds one bit per channel and is shared by every channel.
+    int channels = 1;
+    for (int i = 0; i < 8; i++)
     {
-        inputs[POLY_INPUT].setChannels(8);
+        channels = std::max(channels, inputs[IN1_INPUT + i].getChannels());
+    }
 
-        mainOutput = 0.0f;
+    const float scale = params[SCALE_PARAM].getValue();
+    const float offset = params[OFFSET_PARAM].getValue();
 
-        for(int i = 0; i < 8; i++)
-        {
-            ins[i] = inputs[POLY_INPUT].getVoltage(i) >= 1.0f;
-            if (inputs[IN1_INPUT + i].isConnected()) ins[i] = inputs[IN1_INPUT + i].getVoltage() >= 1.0f;
-            lights[IN1_LIGHT + i].value = ins[i] ? 1.0f : 0.0f;
-        }
+    //a mono sync input clocks every channel
+    const bool syncModeEnabled = inputs[SYNC_INPUT].isConnected();
+    const uint32_t readyForProcess = syncModeEnabled ? clockTriggers.process(inputs[SYNC_INPUT], channels) : HCVGateLogic::channelMask(channels);
+
+    if (readyForProcess)
+    {
+        const int polyChannels = std::min(bitDepth, inputs[POLY_INPUT].getChannels());
+        const uint32_t polyBits = HCVGateLogic::getGates(inputs[POLY_INPUT], polyChannels);
 
-        switch(mode)
+        for (int c = 0; c < channels; c += 4)
         {
-            case 0: processUni8(); break;
-            case 1: processBiOff(); break;
-            case 2: processBiSig(); break;
+            const int vectorIndex = c/4;
+            if (((readyForProcess >> c) & 0xF) == 0) continue;
+
+            simd::int32_4 words = 0;
+            for (int i = 0; i < bitDepth; i++)
+            {
+                simd::float_4 bit = simd::float_4::cast(simd::int32_4(((polyBits >> i) & 1) ? -1 : 0));
+                if (i < 8 && inputs[IN1_INPUT + i].isConnected()) bit = inputs[IN1_INPUT + i].getPolyVoltageSimd<simd::float_4>(c) >= 1.0f;
+                words |= HCVDataConverter::setBit(bit, i);
+            }
+
+            simd::float_4 output = HCVDataConverter::decode(words, mode, bitDepth) * 5.0f;
+
+            if (rectMode == 1) output = simd::fmax(0.0f, output);
+            else if (rectMode == 2) output = simd::fabs(output);
+
+            output = output * scale + offset;
+
+            const simd::float_4 clocked = HCVGateLogic::bitsToLanes(readyForProcess >> c);
+            mainOutputs[vectorIndex] = simd::ifelse(clocked, output, mainOutputs[vectorIndex]);
+
+            if (c == 0)
+            {
+                for (int i = 0; i < 8; i++)
+                {
+                    lights[IN1_LIGHT + i].value = (words[0] >> i) & 1 ? 1.0f : 0.0f;
+                }
+            }
         }
 
-        mainOutput *= 5.0f;
-
-        if (rectMode == 1) mainOutput = fmax(0.0f, mainOutput);
-        else if (rectMode == 2) mainOutput = std::abs(mainOutput);
-
-        mainOutput *= params[SCALE_PARAM].getValue();
-        mainOutput += params[OFFSET_PARAM].getValue();
-
-        lights[OUT_POS_LIGHT].setSmoothBrightness(fmaxf(0.0, mainOutput * 0.2f), 10);
-        lights[OUT_NEG_LIGHT].setSmoothBrightness(fmaxf(0.0, mainOutput * 0.2f), 10);
-
-        outputs[MAIN_OUTPUT].setVoltage(mainOutput);
+        lights[OUT_POS_LIGHT].setSmoothBrightness(fmaxf(0.0, mainOutputs[0][0] * 0.2f), 10);
+        lights[OUT_NEG_LIGHT].setSmoothBrightness(fmaxf(0.0, mainOutputs[0][0] * 0.2f), 10);
     }
-}
 
-void DigitalToAnalog::processUni8()
-{
-    if(ins[0]) mainOutput += 1.0f;
-    if(ins[1]) mainOutput += 2.0f;
-    if(ins[2]) mainOutput += 4.0f;
-    if(ins[3]) mainOutput += 8.0f;
-    if(ins[4]) mainOutput += 16.0f;
-    if(ins[5]) mainOutput += 32.0f;
-    if(ins[6]) mainOutput += 64.0f;
-    if(ins[7]) mainOutput += 128.0f;
-
-    mainOutput = mainOutput/255.0f;
+    outputs[MAIN_OUTPUT].setChannels(channels);
+    for (int c = 0; c < channels; c += 4)
+    {
+        outputs[MAIN_OUTPUT].setVoltageSimd(mainOutputs[c/4], c);
+    }
 }
 
-void DigitalToAnalog::processBiOff()
-{
-    if(ins[0]) mainOutput += 1.0f;
-    if(ins[1]) mainOutput += 2.0f;
-    if(ins[2]) mainOutput += 4.0f;
-    if(ins[3]) mainOutput += 8.0f;
-    if(ins[4]) mainOutput += 16.0f;
-    if(ins[5]) mainOutput += 32.0f;
-    if(ins[6]) mainOutput += 64.0f;
-    if(ins[7]) mainOutput += 128.0f;
-
-    mainOutput = mainOutput/255.0f;
-    mainOutput *= 2.0f;
-    mainOutput = mainOutput - 1.0f;
-}
 
-void DigitalToAnalog::processBiSig()
+struct DigitalToAnalogWidget : HCVModuleWidget
 {
-    if(ins[0]) mainOutput += 1.0f;
-    if(ins[1]) mainOutput += 2.0f;
-    if(ins[2]) mainOutput += 4.0f;
-    if(ins[3]) mainOutput += 8.0f;
-    if(ins[4]) mainOutput += 16.0f;
-    if(ins[5]) mainOutput += 32.0f;
-    if(ins[6]) mainOutput += 64.0f;
+    DigitalToAnalogWidget(DigitalToAnalog *module);
 
-    mainOutput = mainOutput/127.0f;
-
-    if(ins[7]) mainOutput *= -1.0f;
-}
+    void appendContextMenu(Menu *menu) override
+    {
+        DigitalToAnalog *converter = dynamic_cast<DigitalToAnalog*>(module);
+        assert(converter);
 
+        std::vector<std::string> depthLabels;
+        for (int i = 1; i <= HCVDataConverter::MAX_BITS; i++)
+        {
+            depthLabels.push_back(std::to_string(i) + " bits");
+        }
 
-struct DigitalToAnalogWidget : HCVModuleWidget { DigitalToAnalogWidget(DigitalToAnalog *module); };
+        menu->addChild(new MenuSeparator());
+        menu->addChild(createIndexSubmenuItem("Bit Depth", depthLabels,
+            [=]() { return size_t(converter->bitDepth - 1); },
+            [=](size_t index) { converter->bitDepth = int(index) + 1; }));
+    }
+};
 
 DigitalToAnalogWidget::DigitalToAnalogWidget(DigitalToAnalog *module)
 {
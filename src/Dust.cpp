@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVRandom.h"
 
 struct Dust : HCVModule
 {
@@ -19,10 +20,18 @@ struct Dust : HCVModule
 		NUM_OUTPUTS
 	};
 
+    //below this impulse probability per sample, the gap to the next impulse is drawn
+    //from its distribution instead of testing every sample
+    static constexpr float SPARSE_THRESHOLD = 0.01f;
+    //longest gap we count down exactly. Longer gaps are redrawn when they run out.
+    static constexpr float MAX_GAP = 16777216.0f;
+
+    HCVRandom4 randomGens[4];
+
     // Arrays for polyphonic support
-    float lastDensity[16] = {};
-    float densityScaled[16] = {};
-    float threshold[16] = {};
+    alignas(16) float gaps[16] = {};
+    alignas(16) float gapThresholds[16];
+    bool gapFires[16] = {};
 
 	Dust()
 	{
@@ -32,9 +41,16 @@ struct Dust : HCVModule
 
 		configInput(RATE_INPUT, "Rate CV");
 		configOutput(DUST_OUTPUT, "Dust");
+
+        for (int i = 0; i < 16; i++)
+        {
+            gapThresholds[i] = -1.0f;
+        }
 	}
 
 	void process(const ProcessArgs &args) override;
+    simd::float_4 processSparse(int _firstChannel, simd::float_4 _thresholds, simd::float_4 &_noise);
+    void drawGap(int _channel, float _threshold, float _uniform);
 
 	// For more advanced Module features, read Rack's engine.hpp header file
 	// - dataToJson, dataFromJson: serialization of internal data
@@ -49,40 +65,93 @@ void Dust::process(const ProcessArgs &args)
     int channels = setupPolyphonyForAllOutputs();
 	
 	const bool bipolar = (params[BIPOLAR_PARAM].getValue() == 0.0);
+    const float rateKnob = params[RATE_PARAM].getValue();
 
-    // Process each channel
-    for (int c = 0; c < channels; c++)
+    // Process four channels at a time
+    for (int c = 0; c < channels; c += 4)
     {
-        float densityInput = params[RATE_PARAM].getValue() + inputs[RATE_INPUT].getPolyVoltage(c);
+        const simd::float_4 densityInput = rateKnob + inputs[RATE_INPUT].getPolyVoltageSimd<simd::float_4>(c);
+        const simd::float_4 density = simd::clamp(densityInput, 0.0f, 4.0f) * 0.25f;
+
+        //impulses per second are sampleRate * density^3, so this is the probability of an impulse per sample
+        const simd::float_4 thresholds = density * density * density;
 
-        if(lastDensity[c] != densityInput)
+        simd::float_4 noise, impulses;
+        if(simd::movemask(thresholds < SPARSE_THRESHOLD) == 0xF)
         {
-            densityScaled[c] = clamp(densityInput, 0.0f, 4.0f) / 4.0f;
-            densityScaled[c] = args.sampleRate * powf(densityScaled[c], 3.0f);
-            lastDensity[c] = densityInput;
-            threshold[c] = (1.0/args.sampleRate) * densityScaled[c];
+            impulses = processSparse(c, thresholds, noise);
         }
+        else
+        {
+            const simd::float_4 noiseValues = randomGens[c/4].nextFloat();
+            impulses = noiseValues < thresholds;
+            noise = noiseValues / thresholds;
+
+            //the sparse path has to draw fresh gaps after this
+            simd::float_4(-1.0f).store(&gapThresholds[c]);
+        }
+
+        simd::float_4 output;
+        if(bipolar) output = simd::clamp((noise * 2.0f - 1.0f) * 5.0f, -5.0f, 5.0f);
+        else output = simd::clamp(noise * HCV_GATE_MAG, 0.0f, HCV_GATE_MAG);
+
+        outputs[DUST_OUTPUT].setVoltageSimd(simd::ifelse(impulses, output, 0.0f), c);
+    }
+}
+
+//Counts down the gap to each channel's next impulse. Equivalent to a test every sample,
+//but the random numbers are only drawn when an impulse fires or the density changes.
+simd::float_4 Dust::processSparse(int _firstChannel, simd::float_4 _thresholds, simd::float_4 &_noise)
+{
+    simd::float_4 remaining = simd::float_4::load(&gaps[_firstChannel]) - 1.0f;
+    remaining.store(&gaps[_firstChannel]);
+
+    const simd::float_4 expired = remaining <= 0.0f;
+    const simd::float_4 changed = _thresholds != simd::float_4::load(&gapThresholds[_firstChannel]);
+    _noise = 0.0f;
+
+    if(simd::movemask(expired | changed) == 0) return simd::float_4::zero();
+
+    HCVRandom4& randomGen = randomGens[_firstChannel/4];
+    _noise = randomGen.nextFloat();
+    const simd::float_4 newGapNoise = randomGen.nextFloat();
+    const simd::float_4 nextGapNoise = randomGen.nextFloat();
 
-        const float noiseValue = static_cast <float> (rand()) / static_cast <float> (RAND_MAX);
+    float impulses[4] = {};
+    for (int i = 0; i < 4; i++)
+    {
+        const int channel = _firstChannel + i;
 
-        if (noiseValue < threshold[c])
+        //gaps are memoryless, so a density change just starts a new gap from this sample
+        if(_thresholds[i] != gapThresholds[channel])
         {
-            if(bipolar)
-            {
-                const float scale = (threshold[c] > 0.0f) ? 2.0f/threshold[c] : 0.0f;
-                outputs[DUST_OUTPUT].setVoltage(clamp((noiseValue * scale - 1.0f) * 5.0f, -5.0f, 5.0f), c);
-            }
-            else
-            {
-                const float scale = (threshold[c] > 0.0f) ? 1.0f/threshold[c] : 0.0f;
-                outputs[DUST_OUTPUT].setVoltage(clamp(noiseValue * scale * HCV_GATE_MAG, 0.0f, HCV_GATE_MAG), c);
-            }
+            drawGap(channel, _thresholds[i], newGapNoise[i]);
+            gaps[channel] -= 1.0f;
         }
-        else
+
+        if(gaps[channel] <= 0.0f)
         {
-            outputs[DUST_OUTPUT].setVoltage(0.0f, c);
+            impulses[i] = gapFires[channel] ? 1.0f : 0.0f;
+            drawGap(channel, _thresholds[i], nextGapNoise[i]);
         }
     }
+
+    return simd::float_4::load(impulses) != 0.0f;
+}
+
+//samples until the next impulse follow a geometric distribution
+void Dust::drawGap(int _channel, float _threshold, float _uniform)
+{
+    gapThresholds[_channel] = _threshold;
+
+    float gap = MAX_GAP;
+    if(_threshold > 0.0f)
+    {
+        gap = 1.0f + std::floor(std::log(1.0f - _uniform) / std::log1p(-_threshold));
+    }
+
+    gapFires[_channel] = gap < MAX_GAP;
+    gaps[_channel] = std::min(gap, float(MAX_GAP));
 }
 
 struct DustWidget : HCVModuleWidget { DustWidget(Dust *module); };
@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVOversampler.h"
 
 struct Exponent : HCVModule
 {
@@ -45,6 +46,34 @@ struct Exponent : HCVModule
 					outs[4] = {0.0f, 0.0f, 0.0f, 0.0f},
 					expos[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 
+	HCVOversampler4 oversamplers[4];
+	HCVADAA4 antialiasers[4];
+	int oversampling = 0;
+	bool antialiasing = false;
+
+	void onReset() override
+	{
+		oversampling = 0;
+		antialiasing = false;
+	}
+
+	json_t *dataToJson() override
+	{
+		json_t *rootJ = json_object();
+		json_object_set_new(rootJ, "oversampling", json_integer(oversampling));
+		json_object_set_new(rootJ, "antialiasing", json_boolean(antialiasing));
+		return rootJ;
+	}
+
+	void dataFromJson(json_t *rootJ) override
+	{
+		json_t *oversamplingJ = json_object_get(rootJ, "oversampling");
+		if (oversamplingJ) oversampling = clamp(int(json_integer_value(oversamplingJ)), 0, HCVOversampler4::MAX_STAGES);
+
+		json_t *antialiasingJ = json_object_get(rootJ, "antialiasing");
+		if (antialiasingJ) antialiasing = json_boolean_value(antialiasingJ);
+	}
+
 	// For more advanced Module features, read Rack's engine.hpp header file
 	// - dataToJson, dataFromJson: serialization of internal data
 	// - onSampleRateChange: event triggered by a change of sample rate
@@ -81,24 +110,40 @@ void Exponent::process(const ProcessArgs &args)
 		expos[vectorIndex] = (expos[vectorIndex] * scale) + amount;
 		expos[vectorIndex] = clamp(expos[vectorIndex], -5.0f, 5.0f) * 0.2f;
 
-		for (int i = 0; i < 4; i++)
+		//negative shapes map to [0.5, 1], positive shapes to [1, 2]
+		expos[vectorIndex] = 1.0f + expos[vectorIndex] * simd::ifelse(expos[vectorIndex] < 0.0f, 0.5f, 1.0f);
+
+		//|x|^e as 2^(e * log2|x|). Zero inputs are zeroed by sgn().
+		//The antiderivative |x|^(e + 1)/(e + 1) is even, so it needs no sign.
+		const simd::float_4 expo = expos[vectorIndex];
+		auto shaper = [&](simd::float_4 _x) { return fastExp2(expo * fastLog2(abs(_x))) * sgn(_x); };
+		auto antiderivative = [&](simd::float_4 _x) { return fastExp2((expo + 1.0f) * fastLog2(abs(_x))) / (expo + 1.0f); };
+
+		oversamplers[vectorIndex].setStages(oversampling);
+		outs[vectorIndex] = oversamplers[vectorIndex].process(ins[vectorIndex], [&](simd::float_4 _x)
 		{
-			if (expos[vectorIndex][i] < 0.0f)
-			{
-				expos[vectorIndex][i] = 1.0f - (expos[vectorIndex][i] * -0.5f);
-			}
-			else expos[vectorIndex][i] += 1.0f;
-		}
-
-		outs[vectorIndex] = pow(abs(ins[vectorIndex]), expos[vectorIndex]);
-		outs[vectorIndex] *= sgn(ins[vectorIndex]);
+			return antialiasing ? antialiasers[vectorIndex].process(_x, shaper, antiderivative) : shaper(_x);
+		});
 		outs[vectorIndex] *= upscale;
 
 		outs[vectorIndex].store(outputs[MAIN_OUTPUT].getVoltages(c));
 	}
 }
 
-struct ExponentWidget : HCVModuleWidget { ExponentWidget(Exponent *module); };
+struct ExponentWidget : HCVModuleWidget
+{
+	ExponentWidget(Exponent *module);
+
+	void appendContextMenu(Menu *menu) override
+	{
+		Exponent *exponent = dynamic_cast<Exponent*>(module);
+		assert(exponent);
+
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createIndexPtrSubmenuItem("Oversampling", HCVOversampler4::getLabels(), &exponent->oversampling));
+		menu->addChild(createBoolPtrMenuItem("Antiderivative Anti-aliasing", "", &exponent->antialiasing));
+	}
+};
 
 ExponentWidget::ExponentWidget(Exponent *module)
 {
@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVGateLogic.h"
 #include "DSP/HCVChaos.h" 
 #include "DSP/HCVDCFilter.h"
 #include "DSP/HCVSampleRate.h"
@@ -90,7 +91,7 @@ struct FBSineChaos : HCVModule
     float xVal[16] = {}, yVal[16] = {};
     float chaosAmountA[16] = {}, chaosAmountB[16] = {}, chaosAmountC[16] = {}, chaosAmountD[16] = {};
 
-    rack::dsp::SchmittTrigger clockTrigger[16];
+    HCVSchmittBank clockTrigger;
 
     HCVSampleRate sRate[16];
     HCVSRateInterpolator slewX[16], slewY[16];
@@ -113,6 +114,9 @@ void FBSineChaos::process(const ProcessArgs &args)
     // Global mode setting (front-panel switch)
     const bool brokenMode = (params[MODE_PARAM].getValue() > 0.0f);
 
+    const bool clockConnected = inputs[CLOCK_INPUT].isConnected();
+    const uint32_t clocks = clockConnected ? clockTrigger.process(inputs[CLOCK_INPUT], channels) : 0;
+
     // Process each channel
     for (int c = 0; c < channels; c++)
     {
@@ -120,7 +124,7 @@ void FBSineChaos::process(const ProcessArgs &args)
         sRate[c].setSampleRateFactor(sr);
 
         bool isReady = sRate[c].readyForNextSample();
-        if(inputs[CLOCK_INPUT].isConnected()) isReady = clockTrigger[c].process(inputs[CLOCK_INPUT].getPolyVoltage(c));
+        if(clockConnected) isReady = (clocks >> c) & 1;
 
         if(isReady)
         {   
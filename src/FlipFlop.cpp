@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVGateLogic.h"
 
 struct FlipFlop : HCVModule
 {
@@ -32,11 +33,11 @@ struct FlipFlop : HCVModule
         NUM_LIGHTS
     };
 
-    // Arrays for polyphonic support
-    dsp::SchmittTrigger clockTrigger[16];
-    float outs[16][4] = {};
-    bool toggle[16] = {};
-    bool dataIn[16] = {};
+    // Bitmasks for polyphonic support, bit c holds channel c
+    HCVSchmittBank clockTrigger;
+    uint32_t toggle = 0;
+    uint32_t dataLatched = 0;
+    uint32_t dataIn = 0;
 
     FlipFlop()
     {
@@ -57,15 +58,9 @@ struct FlipFlop : HCVModule
 
     void onReset() override
     {
-        for (int c = 0; c < 16; c++)
-        {
-            toggle[c] = false;
-            dataIn[c] = false;
-            outs[c][0] = 0.0f;
-            outs[c][1] = 0.0f;
-            outs[c][2] = HCV_GATE_MAG;
-            outs[c][3] = HCV_GATE_MAG;
-        }
+        toggle = 0;
+        dataLatched = 0;
+        dataIn = 0;
     }
 
     // For more advanced Module features, read Rack's engine.hpp header file
@@ -78,37 +73,27 @@ void FlipFlop::process(const ProcessArgs &args)
 {
     // Determine the number of channels based on connected inputs
     int channels = setupPolyphonyForAllOutputs();
+    const uint32_t allChannels = HCVGateLogic::channelMask(channels);
 
-    // Process each channel
-    for (int c = 0; c < channels; c++)
-    {
-        dataIn[c] = (inputs[IND_INPUT].getPolyVoltage(c) >= 1.0f);
-
-        if (clockTrigger[c].process(inputs[INT_INPUT].getPolyVoltage(c)))
-        {
-            toggle[c] = !toggle[c];
+    dataIn = HCVGateLogic::getGates(inputs[IND_INPUT], channels);
+    const uint32_t clocked = clockTrigger.process(inputs[INT_INPUT], channels);
 
-            outs[c][0] = toggle[c] ? HCV_GATE_MAG : 0.0f;
-            outs[c][1] = dataIn[c] ? HCV_GATE_MAG : 0.0f;
+    toggle ^= clocked;
+    dataLatched = (dataLatched & ~clocked) | (dataIn & clocked);
 
-            outs[c][2] = HCV_GATE_MAG - outs[c][0];
-            outs[c][3] = HCV_GATE_MAG - outs[c][1];
-        }
-
-        outputs[FFT_OUTPUT].setVoltage(outs[c][0], c);
-        outputs[FFD_OUTPUT].setVoltage(outs[c][1], c);
-        outputs[FFTNOT_OUTPUT].setVoltage(outs[c][2], c);
-        outputs[FFDNOT_OUTPUT].setVoltage(outs[c][3], c);
-    }
+    HCVGateLogic::setGates(outputs[FFT_OUTPUT], toggle, channels, HCV_GATE_MAG);
+    HCVGateLogic::setGates(outputs[FFD_OUTPUT], dataLatched, channels, HCV_GATE_MAG);
+    HCVGateLogic::setGates(outputs[FFTNOT_OUTPUT], ~toggle & allChannels, channels, HCV_GATE_MAG);
+    HCVGateLogic::setGates(outputs[FFDNOT_OUTPUT], ~dataLatched & allChannels, channels, HCV_GATE_MAG);
 
     // Lights show the state of channel 0
-    lights[DATA_LIGHT].value = dataIn[0] ? HCV_GATE_MAG : 0.0f;
+    lights[DATA_LIGHT].value = (dataIn & 1) ? HCV_GATE_MAG : 0.0f;
     lights[TOGGLE_LIGHT].value = (inputs[INT_INPUT].getVoltage() >= 1.0f) ? HCV_GATE_MAG : 0.0f;
 
-    lights[FFT_LIGHT].value = outs[0][0];
-    lights[FFD_LIGHT].value = outs[0][1];
-    lights[FFTNOT_LIGHT].value = outs[0][2];
-    lights[FFDNOT_LIGHT].value = outs[0][3];
+    lights[FFT_LIGHT].value = (toggle & 1) ? HCV_GATE_MAG : 0.0f;
+    lights[FFD_LIGHT].value = (dataLatched & 1) ? HCV_GATE_MAG : 0.0f;
+    lights[FFTNOT_LIGHT].value = (toggle & 1) ? 0.0f : HCV_GATE_MAG;
+    lights[FFDNOT_LIGHT].value = (dataLatched & 1) ? 0.0f : HCV_GATE_MAG;
 }
 
 struct FlipFlopWidget : HCVModuleWidget { FlipFlopWidget(FlipFlop *module); };
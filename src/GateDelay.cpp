@@ -1,5 +1,6 @@
 #include "HetrickCV.hpp"
 #include "DSP/HCVTiming.h"
+#include "DSP/HCVGateLogic.h"
 
 struct GateDelay : HCVModule
 {
@@ -33,7 +34,7 @@ struct GateDelay : HCVModule
         NUM_LIGHTS
 	};
 
-    dsp::SchmittTrigger clockTrigger[16];
+    HCVSchmittBank clockTrigger;
     HCVTriggerDelay delayGates[16];
     float gateOuts[16];
     const float maxTime = 5.0f;
@@ -66,10 +67,10 @@ struct GateDelay : HCVModule
     {
         for(int i = 0; i < 16; i++)
         {
-            clockTrigger[i].reset();
             delayGates[i].reset();
             gateOuts[i] = 0.0f;
         }
+        clockTrigger.reset();
     }
 
 	// For more advanced Module features, read Rack's engine.hpp header file
@@ -89,13 +90,20 @@ void GateDelay::process(const ProcessArgs &args)
 
     const float gateButton = params[GATEBUTTON_PARAM].getValue() * 2.0f;
 
-    outputs[DELAY_OUTPUT].setChannels(getMaxInputPolyphony());
+    const int channels = getMaxInputPolyphony();
+    outputs[DELAY_OUTPUT].setChannels(channels);
 
-    for (int i = 0; i < getMaxInputPolyphony(); i++)
+    uint32_t clocks = 0;
+    for (int c = 0; c < channels; c += 4)
     {
-        float allGates = inputs[GATE1_INPUT].getPolyVoltage(i) + inputs[GATE2_INPUT].getPolyVoltage(i);
+        simd::float_4 allGates = inputs[GATE1_INPUT].getPolyVoltageSimd<simd::float_4>(c) + inputs[GATE2_INPUT].getPolyVoltageSimd<simd::float_4>(c);
         allGates += gateButton;
-        if (clockTrigger[i].process(allGates))
+        clocks |= clockTrigger.process(c, allGates, channels);
+    }
+
+    for (int i = 0; i < channels; i++)
+    {
+        if ((clocks >> i) & 1)
         {
             float delayTime = ((inputs[DELAYCV_INPUT].getPolyVoltage(i)) * delayDepth) + delayKnob;
             delayTime = clamp(delayTime, 0.0f, maxTime);
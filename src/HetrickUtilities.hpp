@@ -2,6 +2,7 @@
 
 #include "rack.hpp"
 #include "engine/Engine.hpp"
+#include <cstring>
 #include "DSP/HCVFunctions.h"
 #include "Gamma/Domain.h"
 
@@ -49,6 +50,12 @@ float clockMultToBipolarParamUnscalar(float _clockMult);
 
 struct HCVModule : Module
 {
+    HCVModule()
+    {
+        uiRateDivider.setDivision(HCV_UI_RATE_DIVISION);
+        idleCheckDivider.setDivision(HCV_UI_RATE_DIVISION);
+    }
+
 	float normalizeParameter(float value)
     {
         float temp = value*0.1+0.5;
@@ -108,16 +115,146 @@ struct HCVModule : Module
         return channels;
     }
 
+    //Rack has no event for an upstream module changing its channel count, so the inputs are still read every
+    //sample, but the outputs are only touched when the count changes or a cable is added.
     int setupPolyphonyForAllOutputs()
     {
-        int numChannels = getMaxInputPolyphony();
-        for(auto& output : outputs)
+        const int numChannels = getMaxInputPolyphony();
+        if(numChannels != polyphony || outputChannelsStale)
         {
-            output.setChannels(numChannels);
+            for(auto& output : outputs)
+            {
+                output.setChannels(numChannels);
+            }
+            outputChannelsStale = false;
+            polyphony = numChannels;
         }
         return numChannels;
     }
 
+    //Bit i is set while output i has a cable. It only changes when a cable is added or removed,
+    //so process() can test it every sample and skip outputs nobody is listening to.
+    //Outputs past the first 64 are reported as connected.
+    bool isOutputConnected(int _outputIndex) const
+    {
+        if(_outputIndex >= MAX_TRACKED_OUTPUTS) return true;
+        return (connectedOutputs >> _outputIndex) & 1;
+    }
+
+    uint64_t getConnectedOutputs() const
+    {
+        return connectedOutputs;
+    }
+
+    void onPortChange(const PortChangeEvent& e) override
+    {
+        if(e.type == Port::OUTPUT && e.portId < MAX_TRACKED_OUTPUTS)
+        {
+            const uint64_t bit = uint64_t(1) << e.portId;
+            if(e.connecting) connectedOutputs |= bit;
+            else connectedOutputs &= ~bit;
+        }
+        //a newly patched output starts out with one channel
+        outputChannelsStale = true;
+        wakeUp();
+        Module::onPortChange(e);
+    }
+
+    //bypassing sets the outputs to the channel counts of the bypass routes
+    void onUnBypass(const UnBypassEvent& e) override
+    {
+        outputChannelsStale = true;
+        wakeUp();
+        Module::onUnBypass(e);
+    }
+
+    //Opt-in idle detection for modules whose outputs only depend on their current inputs, params and settings.
+    //Call enableIdleDetection() after config(). isIdle() returns true once every input and param has held still
+    //for HCV_IDLE_SETTLE_TIME, so process() can return early and leave its outputs where they are.
+    //The settle time gives smoothed lights room to finish. Settings outside the params have to call wakeUp().
+    //Only worth it where the skipped work clearly costs more than comparing the inputs and params.
+    void enableIdleDetection()
+    {
+        idleFrame.assign(inputs.size() * (PORT_MAX_CHANNELS + 1) + params.size(), 0.0f);
+        wakeUp();
+    }
+
+    bool isIdle(const ProcessArgs &args)
+    {
+        if(idleFrame.empty()) return false;
+
+        //after a change the module is busy, so the comparison waits for the next UI rate tick
+        if(idleCheckDivider.getClock() > 0)
+        {
+            idleCheckDivider.process();
+            return false;
+        }
+
+        bool changed = false;
+        float* frame = idleFrame.data();
+
+        for (auto& input : inputs)
+        {
+            const int channels = input.getChannels();
+            if(frame[0] != channels)
+            {
+                frame[0] = channels;
+                changed = true;
+            }
+
+            //every block of four that a SIMD read can touch
+            const size_t compareBytes = ((channels + 3) & ~3) * sizeof(float);
+            if(std::memcmp(frame + 1, input.getVoltages(), compareBytes) != 0)
+            {
+                std::memcpy(frame + 1, input.getVoltages(), compareBytes);
+                changed = true;
+            }
+            frame += PORT_MAX_CHANNELS + 1;
+        }
+
+        for (auto& param : params)
+        {
+            const float value = param.getValue();
+            if(*frame != value)
+            {
+                *frame = value;
+                changed = true;
+            }
+            frame++;
+        }
+
+        if(changed)
+        {
+            idleTime = 0.0f;
+            idleCheckDivider.process();
+            return false;
+        }
+
+        if(idleTime < HCV_IDLE_SETTLE_TIME) idleTime += args.sampleTime;
+        return idleTime >= HCV_IDLE_SETTLE_TIME;
+    }
+
+    void wakeUp()
+    {
+        idleTime = 0.0f;
+    }
+
+    //Calls _module->processChannels<N>(args, channels) with the channel count as a template argument for the
+    //common polyphonies, so loops over channels and four channel blocks have fixed trip counts and unroll.
+    //Other counts call processChannels<0>, which takes the count at run time.
+    template <typename M>
+    static void processWithChannelCount(M* _module, const ProcessArgs &args, int _channels)
+    {
+        switch(_channels)
+        {
+            case 1:  _module->template processChannels<1>(args, 1); break;
+            case 4:  _module->template processChannels<4>(args, 4); break;
+            case 8:  _module->template processChannels<8>(args, 8); break;
+            case 16: _module->template processChannels<16>(args, 16); break;
+            default: _module->template processChannels<0>(args, _channels); break;
+        }
+    }
+
     void setBipolarLightBrightness(int _initialLightIndex, float _normalizedValue)
     {
         lights[_initialLightIndex].setBrightness(fmaxf(0.0f, _normalizedValue));
@@ -133,7 +270,52 @@ struct HCVModule : Module
         lights[_lightIndex].setBrightnessSmooth(outputs[_outputIndex].getVoltage() * _scale, APP->engine->getSampleTime() * 4.0f);
     }
 
+    //UI-rate processing for banks of momentary buttons and lights.
+    //Rack holds a momentary button down for at least one UI frame, which is far longer than
+    //HCV_UI_RATE_DIVISION samples, so polling at this rate never misses a press.
+    bool processUIRate()
+    {
+        return uiRateDivider.process();
+    }
+
+    float getUIRateSampleTime(const ProcessArgs &args)
+    {
+        return args.sampleTime * uiRateDivider.getDivision();
+    }
+
+    //returns a bitmask with bit i set for each button that was pressed since the last poll
+    uint64_t pollMomentaryButtons(int _firstParamIndex, dsp::BooleanTrigger* _triggers, int _numButtons)
+    {
+        uint64_t pressed = 0;
+        for (int i = 0; i < _numButtons; i++)
+        {
+            if(_triggers[i].process(params[_firstParamIndex + i].getValue())) pressed |= uint64_t(1) << i;
+        }
+        return pressed;
+    }
+
+    //RGB step lights. red: step is beyond the step count, green: step is on, blue: step is playing (-1 for none)
+    void setStepLights(int _firstLightIndex, int _numSteps, float _stepsKnob, uint64_t _stepsOn, int _playingStep, float _lightTime)
+    {
+        for (int i = 0; i < _numSteps; i++)
+        {
+            lights[_firstLightIndex + 3 * i + 0].setBrightness(i >= _stepsKnob);
+            lights[_firstLightIndex + 3 * i + 1].setBrightness((_stepsOn >> i) & 1);
+            lights[_firstLightIndex + 3 * i + 2].setSmoothBrightness(_playingStep == i, _lightTime);
+        }
+    }
+
     static constexpr float HCV_GATE_MAG = 10.0f;
+    static constexpr int HCV_UI_RATE_DIVISION = 32;
+    static constexpr int MAX_TRACKED_OUTPUTS = 64;
+    static constexpr float HCV_IDLE_SETTLE_TIME = 0.25f;
+    dsp::ClockDivider uiRateDivider;
+    uint64_t connectedOutputs = 0;
+    int polyphony = 0;
+    bool outputChannelsStale = true;
+    dsp::ClockDivider idleCheckDivider;
+    std::vector<float> idleFrame;
+    float idleTime = 0.0f;
 };
 
 //many thanks to Marc at Impromptu for these excellent classes.
@@ -1,5 +1,6 @@
 #include "HetrickCV.hpp"
 #include "DSP/HCVTiming.h"
+#include "DSP/HCVGateLogic.h"
 
 struct LogicCombine : HCVModule
 {
@@ -36,10 +37,9 @@ struct LogicCombine : HCVModule
         NUM_LIGHTS
 	};
 
-    static constexpr int totalInputs = 24;
-    bool ins[totalInputs] = {};
-    bool trigs[totalInputs] = {};
-    dsp::SchmittTrigger inTrigs[totalInputs];
+    //bits 0-7 hold the mono inputs, bits 8-23 hold the poly input channels
+    uint32_t ins = 0;
+    uint32_t lastIns = ~uint32_t(0);
 
     HCVTriggeredGate triggerProcessor;
 
@@ -78,31 +78,32 @@ struct LogicCombine : HCVModule
 
 void LogicCombine::process(const ProcessArgs &args)
 {
-    orState = false;
-    trigState = false;
-
     //inputs[POLY_INPUT].setChannels(16);
 
-    for(int i = 0; i < NUM_INPUTS; i++)
+    ins = 0;
+    for(int i = 0; i < 8; i++)
     {
-        ins[i] = (inputs[IN1_INPUT + i].getVoltage() >= 1.0f);
-
-        trigs[i] = inTrigs[i].process(ins[i] ? HCV_GATE_MAG : 0.0f);
-
-        orState = orState || ins[i];
-        trigState = trigState || trigs[i];
+        if(inputs[IN1_INPUT + i].getVoltage() >= 1.0f) ins |= 1 << i;
     }
 
-    for(int i = 0; i < inputs[POLY_INPUT].getChannels(); i++)
+    //the first poly channel is always read, so it also works while the poly input is unpatched
+    const int polyChannels = std::max(1, inputs[POLY_INPUT].getChannels());
+    for(int c = 0; c < polyChannels; c += 4)
     {
-        int polyIndex = i+8; //offset by 8, since we process the 8 non-poly channels above
-        ins[polyIndex] =  inputs[POLY_INPUT].getVoltage(i) >= 1.0f;
-        trigs[polyIndex] = inTrigs[polyIndex].process(ins[polyIndex] ? HCV_GATE_MAG : 0.0f);
-
-        orState = orState || ins[polyIndex];
-        trigState = trigState || trigs[polyIndex];
+        const simd::float_4 polyVoltages = simd::float_4::load(inputs[POLY_INPUT].getVoltages(c));
+        ins |= uint32_t(simd::movemask(polyVoltages >= 1.0f)) << (c + 8);
     }
 
+    const uint32_t active = 0xFF | (HCVGateLogic::channelMask(polyChannels) << 8);
+    ins &= active;
+
+    //each input triggers on its rising edge, like a SchmittTrigger fed with its gate
+    const uint32_t trigs = ins & ~lastIns;
+    lastIns = (lastIns & ~active) | ins;
+
+    orState = ins != 0;
+    trigState = trigs != 0;
+
     outs[0] = orState ? HCV_GATE_MAG : 0.0f;
     outs[1] = HCV_GATE_MAG - outs[0];
     outs[2] = triggerProcessor.process(trigState) ? HCV_GATE_MAG : 0.0f;
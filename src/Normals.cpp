@@ -71,16 +71,14 @@ void Normals::process(const ProcessArgs &args)
 {
     int numChannels = setupPolyphonyForAllOutputs();
 
-    for (int chan = 0; chan < numChannels; chan++)
+    for (int row = 0; row < 8; row++)
     {
-        for (int row = 0; row < 8; row++)
+        if(!isOutputConnected(OUT1_OUTPUT + row)) continue;
+
+        Input& source = inputs[NORMAL1_INPUT + row].isConnected() ? inputs[NORMAL1_INPUT + row] : inputs[IN1_INPUT + row];
+        for (int chan = 0; chan < numChannels; chan += 4)
         {
-            float input = inputs[IN1_INPUT + row].getPolyVoltage(chan);
-            if (inputs[NORMAL1_INPUT + row].isConnected())
-            {
-                input = inputs[NORMAL1_INPUT + row].getPolyVoltage(chan);
-            }
-            outputs[OUT1_OUTPUT + row].setVoltage(input, chan);
+            outputs[OUT1_OUTPUT + row].setVoltageSimd(source.getPolyVoltageSimd<simd::float_4>(chan), chan);
         }
     }
 }
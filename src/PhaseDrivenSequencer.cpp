@@ -1,5 +1,6 @@
 #include "HetrickCV.hpp"
 #include "DSP/Phasors/HCVPhasorAnalyzers.h"
+#include "DSP/Phasors/HCVPhasorGates.h"
 #include "DSP/HCVTiming.h"
 
 struct PhaseDrivenSequencer : HCVModule
@@ -52,7 +53,7 @@ struct PhaseDrivenSequencer : HCVModule
     float volts[NUM_STEPS] = {};
     float heldVolts[NUM_STEPS] = {};
 
-    bool gates[NUM_STEPS] = {};
+    HCVGatePattern<NUM_STEPS> gates;
     bool smartDetection = true;
     dsp::BooleanTrigger gateTriggers[NUM_STEPS];
 
@@ -94,47 +95,29 @@ struct PhaseDrivenSequencer : HCVModule
 
     void onReset() override
     {
+        gates.clear();
         for (int i = 0; i < NUM_STEPS; i++) 
         {
-			gates[i] = false;
             heldVolts[i] = 0.0f;
 		}
     }
 
     void onRandomize() override 
     {
-		for (int i = 0; i < NUM_STEPS; i++) 
-        {
-			gates[i] = random::get<bool>();
-		}
+		gates.randomize();
 	}
 
     json_t *dataToJson() override
     {
 		json_t *rootJ = json_object();
 		// states
-        json_t *gateStatesJ = json_array();
-        for (int i = 0; i < NUM_STEPS; i++)
-        {
-			json_t *gateStateJ = json_boolean(gates[i]);
-            json_array_append_new(gateStatesJ, gateStateJ);
-		}
-        json_object_set_new(rootJ, "gateStates", gateStatesJ);
+        json_object_set_new(rootJ, "gateStates", gates.toJson());
 		return rootJ;
 	}
     void dataFromJson(json_t *rootJ) override
     {
 		// states
-        json_t *gateStatesJ = json_object_get(rootJ, "gateStates");
-        if (gateStatesJ)
-        {
-            for (int i = 0; i < NUM_STEPS; i++)
-            {
-				json_t *stateJ = json_array_get(gateStatesJ, i);
-				if (stateJ)
-					gates[i] = json_boolean_value(stateJ);
-			}
-        }
+        gates.fromJson(json_object_get(rootJ, "gateStates"));
 	}
 
 	// For more advanced Module features, read Rack's engine.hpp header file
@@ -159,11 +142,6 @@ void PhaseDrivenSequencer::process(const ProcessArgs &args)
 
     for (int i = 0; i < NUM_STEPS; i++) 
     {
-        if (gateTriggers[i].process(params[GATE_PARAMS + i].getValue())) 
-        {
-            gates[i] ^= true;
-        }
-
         volts[i] = params[VOLT_PARAMS + i].getValue();
     }
 
@@ -203,9 +181,9 @@ void PhaseDrivenSequencer::process(const ProcessArgs &args)
                 if (reversePhasor) gate = (1.0f - fractionalIndex) < pulseWidth ? HCV_PHZ_GATESCALE : 0.0f;
                 else gate = fractionalIndex < pulseWidth ? HCV_PHZ_GATESCALE : 0.0f;
 
-                outputs[GATES_OUTPUT].setVoltage(gates[currentIndex] ? gate : 0.0f, i);
+                outputs[GATES_OUTPUT].setVoltage(gates.get(currentIndex) ? gate : 0.0f, i);
 
-                bool trigger = gate && gates[currentIndex];
+                bool trigger = gate && gates.get(currentIndex);
                 outputs[TRIGS_OUTPUT].setVoltage(triggers[i].process(trigger) ? HCV_PHZ_GATESCALE : 0.0f, i);
 
                 if(trigger) heldVolts[i] = stepOutput;
@@ -219,9 +197,9 @@ void PhaseDrivenSequencer::process(const ProcessArgs &args)
         else
         {
             const float gate = fractionalIndex < pulseWidth ? HCV_PHZ_GATESCALE : 0.0f;
-            outputs[GATES_OUTPUT].setVoltage(gates[currentIndex] && active ? gate : 0.0f, i);
+            outputs[GATES_OUTPUT].setVoltage(gates.get(currentIndex) && active ? gate : 0.0f, i);
 
-            bool trigger = gate && gates[currentIndex];
+            bool trigger = gate && gates.get(currentIndex);
             outputs[TRIGS_OUTPUT].setVoltage(triggers[i].process(trigger) ? HCV_PHZ_GATESCALE : 0.0f, i);
 
             if(trigger) heldVolts[i] = stepOutput;
@@ -243,14 +221,14 @@ void PhaseDrivenSequencer::process(const ProcessArgs &args)
     {
         active = inputs[RUN_INPUT].getPolyVoltage(0) >= 1.0f;
     }
-    bool isPlaying = slopeDetectors[0].isPhasorAdvancing() && active;
 
-    // Gate lights
-    for (int i = 0; i < NUM_STEPS; i++) 
+    // Gate buttons and lights
+    if(processUIRate())
     {
-        lights[GATE_LIGHTS + 3 * i + 0].setBrightness(i >= stepsKnob); //red
-        lights[GATE_LIGHTS + 3 * i + 1].setBrightness(gates[i]); //green
-        lights[GATE_LIGHTS + 3 * i + 2].setSmoothBrightness(isPlaying && lightIndex == i, args.sampleTime); //blue
+        gates.toggleSteps(pollMomentaryButtons(GATE_PARAMS, gateTriggers, NUM_STEPS));
+
+        const bool isPlaying = slopeDetectors[0].isPhasorAdvancing() && active;
+        setStepLights(GATE_LIGHTS, NUM_STEPS, stepsKnob, gates.getBits(), isPlaying ? lightIndex : -1, getUIRateSampleTime(args));
     }
 
     lights[RUN_LIGHT].setBrightness(active ? 1.0f : 0.0f);
@@ -1,6 +1,5 @@
 #include "HetrickCV.hpp"
-#include "DSP/Phasors/HCVPhasorAnalyzers.h"
-#include "DSP/HCVTiming.h"
+#include "DSP/Phasors/HCVPhasorGates.h"
 
 struct PhasorGates64 : HCVModule
 {
@@ -46,14 +45,9 @@ struct PhasorGates64 : HCVModule
         NUM_LIGHTS
 	};
 
-    bool gates[NUM_STEPS] = {};
-    bool smartDetection = true;
+    HCVPhasorGateSequencer<NUM_STEPS> sequencer;
     dsp::BooleanTrigger gateTriggers[NUM_STEPS];
 
-    HCVPhasorSlopeDetector slopeDetectors[16];
-    HCVPhasorStepDetector stepDetectors[16];
-    HCVTriggeredGate triggers[16];
-
 	PhasorGates64()
 	{
         config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
@@ -97,46 +91,25 @@ struct PhasorGates64 : HCVModule
 
     void resetGates()
     {
-        for (int i = 0; i < NUM_STEPS; i++) 
-        {
-			gates[i] = false;
-		}
+        sequencer.pattern.clear();
     }
 
     void randomizeGates()
     {
-        for (int i = 0; i < NUM_STEPS; i++) 
-        {
-			gates[i] = random::get<bool>();
-		}
+        sequencer.pattern.randomize();
     }
 
     json_t *dataToJson() override
     {
 		json_t *rootJ = json_object();
 		// states
-        json_t *gateStatesJ = json_array();
-        for (int i = 0; i < NUM_STEPS; i++)
-        {
-			json_t *gateStateJ = json_boolean(gates[i]);
-            json_array_append_new(gateStatesJ, gateStateJ);
-		}
-        json_object_set_new(rootJ, "gateStates", gateStatesJ);
+        json_object_set_new(rootJ, "gateStates", sequencer.pattern.toJson());
 		return rootJ;
 	}
     void dataFromJson(json_t *rootJ) override
     {
 		// states
-        json_t *gateStatesJ = json_object_get(rootJ, "gateStates");
-        if (gateStatesJ)
-        {
-            for (int i = 0; i < NUM_STEPS; i++)
-            {
-				json_t *stateJ = json_array_get(gateStatesJ, i);
-				if (stateJ)
-					gates[i] = json_boolean_value(stateJ);
-			}
-        }
+        sequencer.pattern.fromJson(json_object_get(rootJ, "gateStates"));
 	}
 
 	// For more advanced Module features, read Rack's engine.hpp header file
@@ -154,88 +127,48 @@ void PhasorGates64::process(const ProcessArgs &args)
     const float widthKnob = params[WIDTH_PARAM].getValue();
     const float widthDepth = params[WIDTHCV_PARAM].getValue();
 
-    int numChannels = setupPolyphonyForAllOutputs();
-    int lightIndex = 0;
+    const int numChannels = setupPolyphonyForAllOutputs();
+    const bool runConnected = inputs[RUN_INPUT].isConnected();
 
-    smartDetection = params[DETECTION_PARAM].getValue() > 0.0f;
+    sequencer.setSmartDetection(params[DETECTION_PARAM].getValue() > 0.0f);
 
-    for (int i = 0; i < numChannels; i++)
+    for (int c = 0; c < numChannels; c += 4)
     {
-        float numSteps = stepsKnob + (stepsDepth * inputs[STEPSCV_INPUT].getPolyVoltage(i));
-        numSteps = clamp(numSteps, 1.0f, float(NUM_STEPS));
-
-        float pulseWidth = widthKnob + (widthDepth * inputs[WIDTHCV_INPUT].getPolyVoltage(i));
-        pulseWidth = clamp(pulseWidth, -5.0f, 5.0f) * 0.1f + 0.5f;
-
-        bool active = true;
-        if(inputs[RUN_INPUT].isConnected())
-        {
-            active = inputs[RUN_INPUT].getPolyVoltage(i) >= 1.0f;
-        }
+        simd::float_4 numSteps = stepsKnob + (stepsDepth * inputs[STEPSCV_INPUT].getPolyVoltageSimd<simd::float_4>(c));
+        numSteps = simd::clamp(numSteps, 1.0f, float(NUM_STEPS));
 
-        const float phasorIn = active ? inputs[PHASOR_INPUT].getPolyVoltage(i) : 0.0f;
-        float normalizedPhasor = scaleAndWrapPhasor(phasorIn);
+        simd::float_4 pulseWidth = widthKnob + (widthDepth * inputs[WIDTHCV_INPUT].getPolyVoltageSimd<simd::float_4>(c));
+        pulseWidth = simd::clamp(pulseWidth, -5.0f, 5.0f) * 0.1f + 0.5f;
 
-        stepDetectors[i].setNumberSteps(numSteps);
-        bool triggered = stepDetectors[i](normalizedPhasor);
-        int currentIndex = stepDetectors[i].getCurrentStep();
-        float fractionalIndex = stepDetectors[i].getFractionalStep();
-
-        if(smartDetection)
+        simd::float_4 active = simd::float_4::mask();
+        if(runConnected)
         {
-            bool reversePhasor = slopeDetectors[i](normalizedPhasor) < 0.0f;
-            bool isZero = normalizedPhasor == 0.0f;
-
-            if(slopeDetectors[i].isPhasorAdvancing() || !isZero)
-            {
-                float fractionalOutput = reversePhasor ? (1.0f - fractionalIndex) : fractionalIndex;
-                float gate = fractionalOutput < pulseWidth ? HCV_PHZ_GATESCALE : 0.0f;
-
-                outputs[GATES_OUTPUT].setVoltage(gates[currentIndex] ? gate : 0.0f, i);
-                outputs[GATES_NOT_OUTPUT].setVoltage(!gates[currentIndex] ? gate : 0.0f, i);
-
-                bool trigger = gate && gates[currentIndex];
-                outputs[TRIGS_OUTPUT].setVoltage(triggers[i].process(trigger) ? HCV_PHZ_GATESCALE : 0.0f, i);
-                outputs[PHASOR_OUTPUT].setVoltage(gates[currentIndex] ? fractionalOutput * HCV_PHZ_UPSCALE : 0.0f, i);
-            }
-            else
-            {
-                outputs[GATES_OUTPUT].setVoltage(0.0f, i);
-                outputs[GATES_NOT_OUTPUT].setVoltage(0.0f, i);
-                outputs[TRIGS_OUTPUT].setVoltage(0.0f, i);
-                outputs[PHASOR_OUTPUT].setVoltage(0.0f, i);
-            }
+            active = inputs[RUN_INPUT].getPolyVoltageSimd<simd::float_4>(c) >= 1.0f;
         }
-        else
-        {
-            const float gate = fractionalIndex < pulseWidth ? HCV_PHZ_GATESCALE : 0.0f;
-            outputs[GATES_OUTPUT].setVoltage(gates[currentIndex] && active ? gate : 0.0f, i);
-            outputs[GATES_NOT_OUTPUT].setVoltage(!gates[currentIndex] && active ? gate : 0.0f, i);
 
-            bool trigger = gate && gates[currentIndex];
-            outputs[TRIGS_OUTPUT].setVoltage(triggers[i].process(trigger) ? HCV_PHZ_GATESCALE : 0.0f, i);
-            outputs[PHASOR_OUTPUT].setVoltage(gates[currentIndex] ? fractionalIndex * HCV_PHZ_UPSCALE : 0.0f, i);
-        }
+        const simd::float_4 phasorIn = simd::ifelse(active, inputs[PHASOR_INPUT].getPolyVoltageSimd<simd::float_4>(c), 0.0f);
+        sequencer.process(c, scaleAndWrapPhasor(phasorIn), numSteps, pulseWidth, active, args.sampleTime);
 
-        if(i == 0) lightIndex = currentIndex;
+        outputs[GATES_OUTPUT].setVoltageSimd(sequencer.getGates(c), c);
+        outputs[GATES_NOT_OUTPUT].setVoltageSimd(sequencer.getInverseGates(c), c);
+        outputs[TRIGS_OUTPUT].setVoltageSimd(sequencer.getTriggers(c), c);
+        outputs[PHASOR_OUTPUT].setVoltageSimd(sequencer.getPhasors(c), c);
     }
 
     bool active = true;
-    if(inputs[RUN_INPUT].isConnected())
+    if(runConnected)
     {
         active = inputs[RUN_INPUT].getPolyVoltage(0) >= 1.0f;
     }
-    bool isPlaying = slopeDetectors[0].isPhasorAdvancing() && active;
 
-    // Gate buttons
-    for (int i = 0; i < NUM_STEPS; i++) 
+    // Gate buttons and lights
+    if(processUIRate())
     {
-        if (gateTriggers[i].process(params[GATE_PARAMS + i].getValue())) {
-            gates[i] ^= true;
-        }
-        lights[GATE_LIGHTS + 3 * i + 0].setBrightness(i >= stepsKnob); //red
-        lights[GATE_LIGHTS + 3 * i + 1].setBrightness(gates[i]); //green
-        lights[GATE_LIGHTS + 3 * i + 2].setSmoothBrightness(isPlaying && lightIndex == i, args.sampleTime); //blue
+        sequencer.pattern.toggleSteps(pollMomentaryButtons(GATE_PARAMS, gateTriggers, NUM_STEPS));
+
+        const bool isPlaying = sequencer.isFirstChannelAdvancing() && active;
+        const int playingStep = isPlaying ? sequencer.getFirstChannelStep() : -1;
+        setStepLights(GATE_LIGHTS, NUM_STEPS, stepsKnob, sequencer.pattern.getBits(), playingStep, getUIRateSampleTime(args));
     }
 
     lights[RUN_LIGHT].setBrightness(active ? 1.0f : 0.0f);
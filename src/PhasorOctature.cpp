@@ -63,36 +63,34 @@ struct PhasorOctature : HCVModule
 
 void PhasorOctature::process(const ProcessArgs &args)
 {
+    //phase offset of each output in turns, and whether it counts down instead of up
+    static const float offsets[NUM_OUTPUTS] = {0.0f, 0.25f, 0.5f, 0.75f, 0.0f, 0.125f, 0.375f, 0.625f, 0.875f, 0.5f};
+    static const bool inverted[NUM_OUTPUTS] = {false, false, false, false, true, false, false, false, false, true};
+
     int numChannels = setupPolyphonyForAllOutputs();
+
+    float normalizedPhasors[16];
     for (int i = 0; i < numChannels; i++)
     {
-        float phasorIn = inputs[PHASOR_INPUT].getPolyVoltage(i);
-        const float normalizedPhasor = scaleAndWrapPhasor(phasorIn);
-
-        const float phasor45  = gam::scl::wrap(normalizedPhasor + 0.125f) * HCV_PHZ_UPSCALE;
-        const float phasor90  = gam::scl::wrap(normalizedPhasor + 0.250f) * HCV_PHZ_UPSCALE;
-        const float phasor135 = gam::scl::wrap(normalizedPhasor + 0.375f) * HCV_PHZ_UPSCALE;
-        const float phasor180 = gam::scl::wrap(normalizedPhasor + 0.500f) * HCV_PHZ_UPSCALE;
-        const float phasor225 = gam::scl::wrap(normalizedPhasor + 0.625f) * HCV_PHZ_UPSCALE;
-        const float phasor270 = gam::scl::wrap(normalizedPhasor + 0.750f) * HCV_PHZ_UPSCALE;
-        const float phasor315 = gam::scl::wrap(normalizedPhasor + 0.875f) * HCV_PHZ_UPSCALE;
-
-        outputs[PHASOR_0_OUTPUT].setVoltage(normalizedPhasor * HCV_PHZ_UPSCALE, i);
-        outputs[PHASOR_90_OUTPUT].setVoltage(phasor90, i);
-        outputs[PHASOR_180_OUTPUT].setVoltage(phasor180, i);
-        outputs[PHASOR_270_OUTPUT].setVoltage(phasor270, i);
-        outputs[PHASOR_INV_OUTPUT].setVoltage((1.0f - normalizedPhasor) * HCV_PHZ_UPSCALE, i);
-
-        outputs[PHASOR_45_OUTPUT].setVoltage(phasor45, i);
-        outputs[PHASOR_135_OUTPUT].setVoltage(phasor135, i);
-        outputs[PHASOR_225_OUTPUT].setVoltage(phasor225, i);
-        outputs[PHASOR_315_OUTPUT].setVoltage(phasor315, i);
-        outputs[PHASOR_180_INV_OUTPUT].setVoltage(10.0f - phasor180, i);
+        normalizedPhasors[i] = scaleAndWrapPhasor(inputs[PHASOR_INPUT].getPolyVoltage(i));
     }
 
-    for (int i = 0; i < NUM_LIGHTS; i++)
+    for (int output = 0; output < NUM_OUTPUTS; output++)
     {
-        lights[i].setBrightness(outputs[i].getVoltage() * 0.1f);
+        if(!isOutputConnected(output))
+        {
+            lights[output].setBrightness(0.0f);
+            continue;
+        }
+
+        for (int i = 0; i < numChannels; i++)
+        {
+            float phasor = offsets[output] == 0.0f ? normalizedPhasors[i] : gam::scl::wrap(normalizedPhasors[i] + offsets[output]);
+            if(inverted[output]) phasor = 1.0f - phasor;
+            outputs[output].setVoltage(phasor * HCV_PHZ_UPSCALE, i);
+        }
+
+        lights[output].setBrightness(outputs[output].getVoltage() * 0.1f);
     }
 }
 
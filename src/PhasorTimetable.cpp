@@ -37,17 +37,8 @@ struct PhasorTimetable : HCVModule
         NUM_LIGHTS = NUM_OUTPUTS
 	};
 
-    HCVPhasorDivMult mult2[16];
-    HCVPhasorDivMult mult3[16];
-    HCVPhasorDivMult mult4[16];
-    HCVPhasorDivMult mult5[16];
-    HCVPhasorDivMult mult8[16];
-
-    HCVPhasorDivMult div2[16];
-    HCVPhasorDivMult div3[16];
-    HCVPhasorDivMult div4[16];
-    HCVPhasorDivMult div5[16];
-    HCVPhasorDivMult div8[16];
+    //ratios are indexed by output, so the divisions come first
+    HCVPhasorRatioBank<NUM_OUTPUTS> timetable;
 
     rack::dsp::SchmittTrigger resetTrigger[16];
 
@@ -70,21 +61,12 @@ struct PhasorTimetable : HCVModule
         configOutput(DIV_5_OUTPUT, "Phasor /5");
         configOutput(DIV_8_OUTPUT, "Phasor /8");
 
-        for(int i = 0; i < 16; i++)
+        const float ratios[NUM_OUTPUTS/2] = {2.0f, 3.0f, 4.0f, 5.0f, 8.0f};
+        for(int i = 0; i < NUM_OUTPUTS/2; i++)
         {
-            mult2[i].setMultiplier(2.0f);
-            mult3[i].setMultiplier(3.0f);
-            mult4[i].setMultiplier(4.0f);
-            mult5[i].setMultiplier(5.0f);
-            mult8[i].setMultiplier(8.0f);
-
-            div2[i].setDivider(2.0f);
-            div3[i].setDivider(3.0f);
-            div4[i].setDivider(4.0f);
-            div5[i].setDivider(5.0f);
-            div8[i].setDivider(8.0f);
+            timetable.setRatio(DIV_2_OUTPUT + i, 1.0f, ratios[i]);
+            timetable.setRatio(MULT_2_OUTPUT + i, ratios[i], 1.0f);
         }
-
 	}
 
 	void process(const ProcessArgs &args) override;
@@ -99,49 +81,24 @@ struct PhasorTimetable : HCVModule
 void PhasorTimetable::process(const ProcessArgs &args)
 {
     int numChannels = setupPolyphonyForAllOutputs();
-    for (int i = 0; i < numChannels; i++)
+    for (int c = 0; c < numChannels; c += 4)
     {
-        if(resetTrigger[i].process(inputs[RESET_INPUT].getPolyVoltage(i)))
+        const int lastChannel = std::min(c + 4, numChannels);
+        for (int i = c; i < lastChannel; i++)
         {
-            mult2[i].reset();
-            mult3[i].reset();
-            mult4[i].reset();
-            mult5[i].reset();
-            mult8[i].reset();
-
-            div2[i].reset();
-            div3[i].reset();
-            div4[i].reset();
-            div5[i].reset();
-            div8[i].reset();
+            if(resetTrigger[i].process(inputs[RESET_INPUT].getPolyVoltage(i)))
+            {
+                timetable.resetChannel(i);
+            }
         }
 
-        float phasorIn = inputs[PHASOR_INPUT].getPolyVoltage(i);
-        const float normalizedPhasor = scaleAndWrapPhasor(phasorIn);
-
-        const float phasorMult2 = mult2[i].basicSync(normalizedPhasor) * HCV_PHZ_UPSCALE;
-        const float phasorMult3 = mult3[i].basicSync(normalizedPhasor) * HCV_PHZ_UPSCALE;
-        const float phasorMult4 = mult4[i].basicSync(normalizedPhasor) * HCV_PHZ_UPSCALE;
-        const float phasorMult5 = mult5[i].basicSync(normalizedPhasor) * HCV_PHZ_UPSCALE;
-        const float phasorMult8 = mult8[i].basicSync(normalizedPhasor) * HCV_PHZ_UPSCALE;
-
-        const float phasorDiv2  = div2[i].basicSync(normalizedPhasor) * HCV_PHZ_UPSCALE;
-        const float phasorDiv3  = div3[i].basicSync(normalizedPhasor) * HCV_PHZ_UPSCALE;
-        const float phasorDiv4  = div4[i].basicSync(normalizedPhasor) * HCV_PHZ_UPSCALE;
-        const float phasorDiv5  = div5[i].basicSync(normalizedPhasor) * HCV_PHZ_UPSCALE;
-        const float phasorDiv8  = div8[i].basicSync(normalizedPhasor) * HCV_PHZ_UPSCALE;
-
-        outputs[MULT_2_OUTPUT].setVoltage(phasorMult2, i);
-        outputs[MULT_3_OUTPUT].setVoltage(phasorMult3, i);
-        outputs[MULT_4_OUTPUT].setVoltage(phasorMult4, i);
-        outputs[MULT_5_OUTPUT].setVoltage(phasorMult5, i);
-        outputs[MULT_8_OUTPUT].setVoltage(phasorMult8, i);
-
-        outputs[DIV_2_OUTPUT].setVoltage(phasorDiv2, i);
-        outputs[DIV_3_OUTPUT].setVoltage(phasorDiv3, i);
-        outputs[DIV_4_OUTPUT].setVoltage(phasorDiv4, i);
-        outputs[DIV_5_OUTPUT].setVoltage(phasorDiv5, i);
-        outputs[DIV_8_OUTPUT].setVoltage(phasorDiv8, i);
+        const simd::float_4 normalizedPhasors = scaleAndWrapPhasor(inputs[PHASOR_INPUT].getPolyVoltageSimd<simd::float_4>(c));
+        timetable.process(c, normalizedPhasors);
+
+        for (int i = 0; i < NUM_OUTPUTS; i++)
+        {
+            outputs[i].setVoltageSimd(timetable.getPhases(i, c) * HCV_PHZ_UPSCALE, c);
+        }
     }
 
     for (int i = 0; i < NUM_LIGHTS; i++)
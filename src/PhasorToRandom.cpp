@@ -1,5 +1,6 @@
 #include "HetrickCV.hpp"
 #include "DSP/Phasors/HCVPhasorEffects.h"
+#include "DSP/HCVSeededTable.h"
 
 struct PhasorToRandom : HCVModule
 {
@@ -36,21 +37,20 @@ struct PhasorToRandom : HCVModule
     static constexpr float MAX_STEPS = 64.0f;
     static constexpr float STEPS_CV_SCALE = MAX_STEPS/5.0f;
 
+    static constexpr int TABLE_SIZE = 64;
+    static constexpr int NUM_VOLTAGES = 16 * TABLE_SIZE;
+
     HCVRandom randomGenerator;
     HCVPhasorStepDetector stepDetectors[16];
-    std::vector<std::vector<float>> randomVoltageArray;
+
+    //one row of step voltages in [0, 10] per channel. The table starts out generated from randomSeed.
+    alignas(16) float randomVoltages[16][TABLE_SIZE];
+    uint64_t randomSeed;
 
 	PhasorToRandom()
 	{
-        randomVoltageArray.resize(16);
-        for(int channel = 0; channel < 16; channel++)
-        {
-            randomVoltageArray[channel].resize(MAX_STEPS);
-            for(int i = 0; i < MAX_STEPS; i++)
-            {
-                randomVoltageArray[channel][i] = randomGenerator.nextFloat() * 10.0f;
-            }
-        }
+        randomSeed = random::u64();
+        HCVSeededTable::fill(randomSeed, &randomVoltages[0][0], NUM_VOLTAGES, 10.0f);
 
         config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
 
@@ -81,28 +81,48 @@ struct PhasorToRandom : HCVModule
     }
 
 
-    //TODO: Save random voltage array to JSON.
     json_t *dataToJson() override
     {
 		json_t *rootJ = json_object();
-        json_t *randomDataJSONArray = json_array();
 
-        // Save the random voltage array to JSON
-        for(int i = 0; i < 16; i++)
+        //the seed and the steps rewritten since, or the whole table as raw floats once that is smaller
+        std::string edits;
+        if(HCVSeededTable::encodeEdits(randomSeed, &randomVoltages[0][0], NUM_VOLTAGES, 10.0f, edits))
         {
-            json_t *channelArray = json_array();
-            for (int j = 0; j < MAX_STEPS; j++)
-            {
-                json_array_append_new(channelArray, json_real(randomVoltageArray[i][j]));
-            }
-            json_array_append_new(randomDataJSONArray, channelArray);
+            json_object_set_new(rootJ, "randomSeed", json_integer(json_int_t(randomSeed)));
+            json_object_set_new(rootJ, "randomEdits", json_string(edits.c_str()));
+        }
+        else
+        {
+            const std::string voltageData = string::toBase64((const uint8_t*) randomVoltages, sizeof(randomVoltages));
+            json_object_set_new(rootJ, "randomVoltageData", json_string(voltageData.c_str()));
         }
 
-        json_object_set_new(rootJ, "randomVoltages", randomDataJSONArray);
 		return rootJ;
 	}
     void dataFromJson(json_t *rootJ) override
     {
+        json_t *seedJ = json_object_get(rootJ, "randomSeed");
+        if(json_is_integer(seedJ))
+        {
+            randomSeed = uint64_t(json_integer_value(seedJ));
+            HCVSeededTable::decode(randomSeed, json_string_value(json_object_get(rootJ, "randomEdits")), &randomVoltages[0][0], NUM_VOLTAGES, 10.0f);
+            return;
+        }
+
+        json_t *voltageDataJ = json_object_get(rootJ, "randomVoltageData");
+        if(voltageDataJ && json_string_value(voltageDataJ))
+        {
+            try
+            {
+                const std::vector<uint8_t> voltageData = string::fromBase64(json_string_value(voltageDataJ));
+                if(voltageData.size() == sizeof(randomVoltages)) std::memcpy(randomVoltages, voltageData.data(), sizeof(randomVoltages));
+            }
+            catch(Exception&) {}
+            return;
+        }
+
+        //older patches stored one array of reals per channel
 		json_t *voltageData = json_object_get(rootJ, "randomVoltages");
 
         if(voltageData)
@@ -112,12 +132,12 @@ struct PhasorToRandom : HCVModule
                 json_t *channelArray = json_array_get(voltageData, i);
                 if (channelArray)
                 {
-                    for (int j = 0; j < MAX_STEPS; j++)
+                    for (int j = 0; j < TABLE_SIZE; j++)
                     {
                         json_t *value = json_array_get(channelArray, j);
                         if (value)
                         {
-                            randomVoltageArray[i][j] = json_real_value(value);
+                            randomVoltages[i][j] = json_real_value(value);
                         }
                     }
                 }
@@ -146,36 +166,47 @@ void PhasorToRandom::process(const ProcessArgs &args)
     const float voltageOffset = voltageRange ? 0.0f : -5.0f;
     const float lightScale = voltageRange ? 0.1f : 0.2f;
 
-    for (int channel = 0; channel < numChannels; channel++)
+    for (int c = 0; c < numChannels; c += 4)
     {
-        float steps = stepsKnob + (stepsCVDepth * inputs[STEPSCV_INPUT].getPolyVoltage(channel));
-        steps = floorf(clamp(steps, 1.0f, MAX_STEPS));
-        stepDetectors[channel].setNumberSteps(steps);
+        //the step detectors and table updates run per channel, the lookups are gathered into one vector each
+        simd::float_4 steppedVoltages = 0.0f, nextVoltages = 0.0f, fractionalSteps = 0.0f;
 
-        float probability = probabilityKnob + (probabilityDepth * inputs[PROBCV_INPUT].getPolyVoltage(channel));
-        probability = clamp(probability, -5.0f, 5.0f) * 0.1f + 0.5f;
+        const int activeLanes = std::min(4, numChannels - c);
+        for (int lane = 0; lane < activeLanes; lane++)
+        {
+            const int channel = c + lane;
 
-        float normalizedPhasor = scaleAndWrapPhasor(inputs[PHASOR_INPUT].getPolyVoltage(channel));
+            float steps = stepsKnob + (stepsCVDepth * inputs[STEPSCV_INPUT].getPolyVoltage(channel));
+            steps = floorf(clamp(steps, 1.0f, MAX_STEPS));
+            stepDetectors[channel].setNumberSteps(steps);
 
-        const bool stepAdvanced = stepDetectors[channel](normalizedPhasor);
-        const int currentStep = stepDetectors[channel].getCurrentStep();
-        const int nextStep = (currentStep + 1) % int(steps);
+            float probability = probabilityKnob + (probabilityDepth * inputs[PROBCV_INPUT].getPolyVoltage(channel));
+            probability = clamp(probability, -5.0f, 5.0f) * 0.1f + 0.5f;
 
-        if(stepAdvanced)
-        {
-            if(randomGenerator.nextProbability(probability))
+            float normalizedPhasor = scaleAndWrapPhasor(inputs[PHASOR_INPUT].getPolyVoltage(channel));
+
+            const bool stepAdvanced = stepDetectors[channel](normalizedPhasor);
+            const int currentStep = stepDetectors[channel].getCurrentStep();
+            const int nextStep = (currentStep + 1) % int(steps);
+
+            float* channelVoltages = randomVoltages[channel];
+            if(stepAdvanced)
             {
-                randomVoltageArray[channel][nextStep] = randomGenerator.nextFloat() * 10.0f;
+                if(randomGenerator.nextProbability(probability))
+                {
+                    channelVoltages[nextStep] = randomGenerator.nextFloat() * 10.0f;
+                }
             }
-        }
 
-        const float fractionalStep = stepDetectors[channel].getFractionalStep();
+            steppedVoltages[lane] = channelVoltages[currentStep];
+            nextVoltages[lane] = channelVoltages[nextStep];
+            fractionalSteps[lane] = stepDetectors[channel].getFractionalStep();
+        }
 
-        const float steppedVoltage = randomVoltageArray[channel][currentStep];
-        const float slewedVoltage = LERP(fractionalStep, randomVoltageArray[channel][nextStep], steppedVoltage);
+        const simd::float_4 slewedVoltages = SIMDLERP(fractionalSteps, nextVoltages, steppedVoltages);
 
-        outputs[STEPPED_OUTPUT].setVoltage(steppedVoltage + voltageOffset, channel);
-        outputs[SLEWED_OUTPUT].setVoltage(slewedVoltage + voltageOffset, channel);
+        outputs[STEPPED_OUTPUT].setVoltageSimd(steppedVoltages + voltageOffset, c);
+        outputs[SLEWED_OUTPUT].setVoltageSimd(slewedVoltages + voltageOffset, c);
     }
 
     setBipolarLightBrightness(STEP_LIGHT, outputs[STEPPED_OUTPUT].getVoltage() * lightScale);
@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVGateLogic.h"
 #include "DSP/Phasors/HCVPhasorEffects.h"
 
 struct PolymetricPhasors : HCVModule
@@ -48,9 +49,9 @@ struct PolymetricPhasors : HCVModule
 	};
 
 
-    HCVPhasorDivMult divMults[3][16];
-    HCVPhasorResetDetector resetDetectors[3][16];
-    dsp::SchmittTrigger resetTriggers[3][16];
+    HCVPhasorRatioBank<3> polymeter;
+    HCVPhasorResetDetector4 finishDetectors[3][4];
+    HCVSchmittBank resetTriggers[3];
 
     const float MAX_NUM_PULSES = 64.0f;
     const float PULSE_CV_SCALAR = MAX_NUM_PULSES/5.0f;
@@ -122,34 +123,53 @@ void PolymetricPhasors::process(const ProcessArgs &args)
     const float reset3Button = params[RESET3_PARAM].getValue();
     const float resetButtons[3] = {reset1Button, reset2Button, reset3Button};
 
-    for (int chan = 0; chan < numChannels; chan++)
+    for (int c = 0; c < numChannels; c += 4)
     {
-        float modulatedInPulses = inStepsCVDepth * inputs[INSTEPS_CV_INPUT].getPolyVoltage(chan) * PULSE_CV_SCALAR;
-        float inPulses = clamp(inStepsKnob + modulatedInPulses, 1.0f, MAX_NUM_PULSES);
-
-        float normalizedPhasor = scaleAndWrapPhasor(inputs[PHASOR_INPUT].getPolyVoltage(chan));
-
+        uint32_t resets[3];
         for (int outSet = 0; outSet < 3; outSet++)
         {
-            float modulatedOutPulses = outStepsCVDepths[outSet] * inputs[OUTSTEPS1_CV_INPUT + outSet].getPolyVoltage(chan) * PULSE_CV_SCALAR;
-            float outPulses = clamp(outStepsKnobs[outSet] + modulatedOutPulses, 1.0f, MAX_NUM_PULSES);
+            const simd::float_4 channelResets = inputs[RESET1_INPUT + outSet].getPolyVoltageSimd<simd::float_4>(c);
+            resets[outSet] = resetTriggers[outSet].process(c, channelResets + resetButtons[outSet], numChannels);
+        }
 
-            divMults[outSet][chan].setDivider(outPulses);
-            divMults[outSet][chan].setMultiplier(inPulses);
+        const int lastChannel = std::min(c + 4, numChannels);
+        for (int chan = c; chan < lastChannel; chan++)
+        {
+            float modulatedInPulses = inStepsCVDepth * inputs[INSTEPS_CV_INPUT].getPolyVoltage(chan) * PULSE_CV_SCALAR;
+            float inPulses = clamp(inStepsKnob + modulatedInPulses, 1.0f, MAX_NUM_PULSES);
 
-            float channelReset = inputs[RESET1_INPUT + outSet].getPolyVoltage(chan);
-            
-            if(resetTriggers[outSet][chan].process(channelReset + resetButtons[outSet]))
+            for (int outSet = 0; outSet < 3; outSet++)
             {
-                divMults[outSet][chan].reset();
-            }
+                float modulatedOutPulses = outStepsCVDepths[outSet] * inputs[OUTSTEPS1_CV_INPUT + outSet].getPolyVoltage(chan) * PULSE_CV_SCALAR;
+                float outPulses = clamp(outStepsKnobs[outSet] + modulatedOutPulses, 1.0f, MAX_NUM_PULSES);
+
+                polymeter.setRatio(outSet, chan, inPulses, outPulses);
 
-            float speedPhasor = divMults[outSet][chan].basicSync(normalizedPhasor);
-            outputs[PHASOR1_OUTPUT + outSet].setVoltage(speedPhasor * HCV_PHZ_UPSCALE, chan);
-            bool resetGate = resetDetectors[outSet][chan].detectProportionalReset(speedPhasor);
-            outputs[FINISH1_OUTPUT + outSet].setVoltage( resetGate ? HCV_PHZ_GATESCALE : 0.0f, chan);
+                if((resets[outSet] >> chan) & 1)
+                {
+                    polymeter.reset(outSet, chan);
+                }
+            }
         }
 
+        //the input phasor is analyzed once and shared by all three output sets
+        const simd::float_4 normalizedPhasors = scaleAndWrapPhasor(inputs[PHASOR_INPUT].getPolyVoltageSimd<simd::float_4>(c));
+        polymeter.process(c, normalizedPhasors);
+
+        for (int outSet = 0; outSet < 3; outSet++)
+        {
+            const simd::float_4 speedPhasors = polymeter.getPhases(outSet, c);
+            outputs[PHASOR1_OUTPUT + outSet].setVoltageSimd(speedPhasors * HCV_PHZ_UPSCALE, c);
+
+            //the first block always runs so the finish lights keep working
+            HCVPhasorResetDetector4& finishDetector = finishDetectors[outSet][c/4];
+            if(c == 0 || outputs[FINISH1_OUTPUT + outSet].isConnected())
+            {
+                const simd::float_4 resetGates = finishDetector.detectProportionalReset(speedPhasors);
+                outputs[FINISH1_OUTPUT + outSet].setVoltageSimd(simd::ifelse(resetGates, HCV_PHZ_GATESCALE, 0.0f), c);
+            }
+            else finishDetector.skipDetection(speedPhasors);
+        }
     }
 
     setLightFromOutput(PHASOR1_LIGHT, PHASOR1_OUTPUT);
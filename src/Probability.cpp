@@ -1,6 +1,7 @@
 #include "HetrickCV.hpp"
 #include "DSP/HCVRandom.h"
 #include "DSP/HCVTiming.h"
+#include "DSP/HCVGateLogic.h"
 
 struct Probability : HCVModule
 {
@@ -42,7 +43,7 @@ struct Probability : HCVModule
 	};
 
     dsp::SchmittTrigger probButtonTrigger, outButtonTrigger;
-    dsp::SchmittTrigger clockTrigger[16];
+    HCVSchmittBank clockTrigger;
     HCVTriggeredGate triggerA[16], triggerB[16];
     bool outALogic[16];
     bool outBLogic[16];
@@ -78,10 +79,10 @@ struct Probability : HCVModule
         {
             outALogic[i] = false;
             outBLogic[i] = false;
-            clockTrigger[i].reset();
             triggerA[i].reset();
             triggerB[i].reset();
         }
+        clockTrigger.reset();
     }
 
     json_t *dataToJson() override
@@ -130,9 +131,11 @@ void Probability::process(const ProcessArgs &args)
     outputs[OUTA_OUTPUT].setChannels(polyChannels);
     outputs[OUTB_OUTPUT].setChannels(polyChannels);
 
+    const uint32_t clocks = clockTrigger.process(inputs[GATE_INPUT], polyChannels);
+
     for (int i = 0; i < polyChannels; i++)
     {
-        if (clockTrigger[i].process(inputs[GATE_INPUT].getPolyVoltage(i)))
+        if ((clocks >> i) & 1)
         {
             float probability = ((inputs[PROBCV_INPUT].getPolyVoltage(i)) * probDepth) + probKnob;
             probability = clamp(probability, 0.0f, 1.0f);
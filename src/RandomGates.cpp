@@ -1,5 +1,6 @@
 #include "HetrickCV.hpp"
 #include "DSP/HCVTiming.h"
+#include "DSP/HCVGateLogic.h"
 
 struct RandomGates : HCVModule
 {
@@ -74,6 +75,9 @@ struct RandomGates : HCVModule
 
     void process(const ProcessArgs &args) override;
 
+    template <int CHANNELS>
+    void processChannels(const ProcessArgs &args, int _channels);
+
     int clampInt(const int _in, const int min = 0, const int max = 7)
     {
         if (_in > max) return max;
@@ -82,7 +86,7 @@ struct RandomGates : HCVModule
     }
 
     // Arrays for polyphonic support
-    dsp::SchmittTrigger clockTrigger[16];
+    HCVSchmittBank clockTrigger;
     dsp::SchmittTrigger modeTrigger;
 
     HCVTriggeredGate trigger[16][8];
@@ -125,7 +129,13 @@ struct RandomGates : HCVModule
 void RandomGates::process(const ProcessArgs &args)
 {
     // Determine the number of channels based on connected inputs
-    int channels = setupPolyphonyForAllOutputs();
+    processWithChannelCount(this, args, setupPolyphonyForAllOutputs());
+}
+
+template <int CHANNELS>
+void RandomGates::processChannels(const ProcessArgs &args, int _channels)
+{
+    const int channels = CHANNELS > 0 ? CHANNELS : _channels;
 
     // Global mode button
     if (modeTrigger.process(params[MODE_PARAM].getValue()))
@@ -133,6 +143,17 @@ void RandomGates::process(const ProcessArgs &args)
         mode = (mode + 1) % 3;
     }
 
+    //the clock triggers when it goes above 1V
+    uint32_t clocks = 0;
+    for (int c = 0; c < channels; c += 4)
+    {
+        const simd::float_4 clockHigh = inputs[CLOCK_INPUT].getPolyVoltageSimd<simd::float_4>(c) > 1.0f;
+        clocks |= clockTrigger.process(c, simd::ifelse(clockHigh, 1.0f, 0.0f), channels);
+    }
+
+    // Bit c of gates[i] holds output i of channel c
+    uint32_t gates[8] = {};
+
     // Process each channel
     for (int c = 0; c < channels; c++)
     {
@@ -146,7 +167,7 @@ void RandomGates::process(const ProcessArgs &args)
 
         const bool clockHigh = inputs[CLOCK_INPUT].getPolyVoltage(c) > 1.0f;
 
-        if (clockTrigger[c].process(clockHigh))
+        if ((clocks >> c) & 1)
         {
             uint32_t range = max-min;
             uint32_t randNum;
@@ -169,21 +190,21 @@ void RandomGates::process(const ProcessArgs &args)
                     trigger[c][i].trigger();
                     active[c][i] = false;
                 }
-                outputs[i].setVoltage((trigger[c][i].process() ? HCV_GATE_MAG : 0.0f), c);
+                gates[i] |= uint32_t(trigger[c][i].process()) << c;
             }
             break;
 
             case 1: //hold mode
             for(int i = 0; i < 8; i++)
             {
-                outputs[i].setVoltage((active[c][i] ? HCV_GATE_MAG : 0.0f), c);
+                gates[i] |= uint32_t(active[c][i]) << c;
             }
             break;
 
             case 2: //gate mode
             for(int i = 0; i < 8; i++)
             {
-                outputs[i].setVoltage(((active[c][i] && clockHigh) ? HCV_GATE_MAG : 0.0f), c);
+                gates[i] |= uint32_t(active[c][i] && clockHigh) << c;
             }
             break;
         }
@@ -194,9 +215,12 @@ void RandomGates::process(const ProcessArgs &args)
     lights[MODE_HOLD_LIGHT].setBrightness(mode == 1 ? 1.0f : 0.0f);
     lights[MODE_GATE_LIGHT].setBrightness(mode == 2 ? 1.0f : 0.0f);
 
+    // The triggers keep running for unpatched outputs, only writing them out is skipped
     for(int i = 0; i < 8; i++)
     {
-        lights[OUT1_LIGHT + i].setBrightnessSmooth(fmaxf(0.0, outputs[i].getVoltage(0)), args.sampleTime * 4.0f);
+        const bool connected = isOutputConnected(OUT1_OUTPUT + i);
+        if(connected) HCVGateLogic::setGates(outputs[OUT1_OUTPUT + i], gates[i], channels, HCV_GATE_MAG);
+        lights[OUT1_LIGHT + i].setBrightnessSmooth((connected && (gates[i] & 1)) ? HCV_GATE_MAG : 0.0f, args.sampleTime * 4.0f);
     }
 }
 
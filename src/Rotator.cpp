@@ -1,4 +1,7 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVRouter.h"
+#include "DSP/HCVGateLogic.h"
+#include <atomic>
 
 struct Rotator : HCVModule
 {
@@ -75,15 +78,116 @@ struct Rotator : HCVModule
             configInput(IN1_INPUT + i, std::to_string(i + 1));
             configOutput(OUT1_OUTPUT + i, std::to_string(i + 1));
         }
+
+        randomizePermutations();
+        enableIdleDetection();
 	}
 
     void process(const ProcessArgs &args) override;
 
-    int clampInt(const int _in, const int min = 0, const int max = 7)
+    template <int CHANNELS>
+    void processChannels(const ProcessArgs &args, int _channels);
+
+    enum RoutingModes
+    {
+        ROTATE_MODE,
+        RANDOM_MODE,
+        NUM_ROUTING_MODES
+    };
+
+    int routingMode = ROTATE_MODE;
+
+    //in random mode, each channel has its own shuffle of the stages for every Rotate position
+    uint8_t permutations[16][HCVRouter8::NUM_STAGES][HCVRouter8::NUM_STAGES];
+    HCVRouter8::Route randomRoutes[16][HCVRouter8::NUM_ROUTES];
+
+    //set from the menu, the tables are reshuffled at the top of process()
+    std::atomic<bool> permutationsRequested{false};
+
+    simd::float_4 ins[HCVRouter8::NUM_STAGES], outs[HCVRouter8::NUM_STAGES];
+
+    void randomizePermutations()
+    {
+        for (int c = 0; c < 16; c++)
+        {
+            for (int rotation = 0; rotation < HCVRouter8::NUM_STAGES; rotation++)
+            {
+                HCVRouter8::randomPermutation(permutations[c][rotation]);
+            }
+        }
+        updateRandomRoutes();
+    }
+
+    void updateRandomRoutes()
+    {
+        for (int c = 0; c < 16; c++)
+        {
+            for (int rotation = 0; rotation < HCVRouter8::NUM_STAGES; rotation++)
+            {
+                for (int stages = 1; stages <= HCVRouter8::NUM_STAGES; stages++)
+                {
+                    randomRoutes[c][HCVRouter8::getRouteIndex(rotation, stages)] = HCVRouter8::fromPermutation(permutations[c][rotation], stages);
+                }
+            }
+        }
+        wakeUp();
+    }
+
+    void onReset() override
+    {
+        routingMode = ROTATE_MODE;
+        wakeUp();
+    }
+
+    void onRandomize() override
+    {
+        randomizePermutations();
+    }
+
+    json_t *dataToJson() override
+    {
+        json_t *rootJ = json_object();
+        json_object_set_new(rootJ, "routingMode", json_integer(routingMode));
+
+        //one string of digits per channel, eight stages for each Rotate position
+        json_t *permutationsJ = json_array();
+        for (int c = 0; c < 16; c++)
+        {
+            std::string digits;
+            for (int rotation = 0; rotation < HCVRouter8::NUM_STAGES; rotation++)
+            {
+                for (int i = 0; i < HCVRouter8::NUM_STAGES; i++) digits += char('0' + permutations[c][rotation][i]);
+            }
+            json_array_append_new(permutationsJ, json_string(digits.c_str()));
+        }
+        json_object_set_new(rootJ, "permutations", permutationsJ);
+
+        return rootJ;
+    }
+
+    void dataFromJson(json_t *rootJ) override
     {
-        if (_in > max) return max;
-        if (_in < min) return min;
-        return _in;
+        json_t *routingModeJ = json_object_get(rootJ, "routingMode");
+        if (routingModeJ) routingMode = clamp(int(json_integer_value(routingModeJ)), 0, NUM_ROUTING_MODES - 1);
+        wakeUp();
+
+        json_t *permutationsJ = json_object_get(rootJ, "permutations");
+        if (permutationsJ)
+        {
+            for (int c = 0; c < 16; c++)
+            {
+                const char* digits = json_string_value(json_array_get(permutationsJ, c));
+                if (!digits || strlen(digits) != HCVRouter8::NUM_STAGES * HCVRouter8::NUM_STAGES) continue;
+
+                for (int rotation = 0; rotation < HCVRouter8::NUM_STAGES; rotation++)
+                {
+                    uint8_t permutation[HCVRouter8::NUM_STAGES];
+                    for (int i = 0; i < HCVRouter8::NUM_STAGES; i++) permutation[i] = uint8_t(digits[rotation * HCVRouter8::NUM_STAGES + i] - '0');
+                    if (HCVRouter8::isPermutation(permutation)) std::copy(permutation, permutation + HCVRouter8::NUM_STAGES, permutations[c][rotation]);
+                }
+            }
+            updateRandomRoutes();
+        }
     }
 
 	// For more advanced Module features, read Rack's engine.hpp header file
@@ -95,22 +199,54 @@ struct Rotator : HCVModule
 
 void Rotator::process(const ProcessArgs &args)
 {
+    if(permutationsRequested.exchange(false))
+    {
+        randomizePermutations();
+        wakeUp();
+    }
+
+    if(isIdle(args)) return;
+
     // Determine the number of channels based on connected inputs
-    int channels = setupPolyphonyForAllOutputs();
+    processWithChannelCount(this, args, setupPolyphonyForAllOutputs());
+}
+
+template <int CHANNELS>
+void Rotator::processChannels(const ProcessArgs &args, int _channels)
+{
+    const int channels = CHANNELS > 0 ? CHANNELS : _channels;
+
+    const float rotateKnob = params[ROTATE_PARAM].getValue();
+    const float stagesKnob = params[STAGES_PARAM].getValue();
 
-    // Process each channel
-    for (int c = 0; c < channels; c++)
+    // Process four channels at a time
+    for (int c = 0; c < channels; c += 4)
     {
-        int rotation = round(params[ROTATE_PARAM].getValue() + inputs[ROTATE_INPUT].getPolyVoltage(c));
-        int stages = round(params[STAGES_PARAM].getValue() + inputs[STAGES_INPUT].getPolyVoltage(c));
+        // Clamping before rounding matches rounding before clamping, and keeps the conversion in range
+        const simd::float_4 rotations = simd::clamp(rotateKnob + inputs[ROTATE_INPUT].getPolyVoltageSimd<simd::float_4>(c), 0.0f, 7.0f);
+        const simd::float_4 stages = simd::clamp(stagesKnob + inputs[STAGES_INPUT].getPolyVoltageSimd<simd::float_4>(c), 0.0f, 7.0f);
+        const simd::int32_4 routeIndices = simd::int32_4(rotations + 0.5f) * HCVRouter8::NUM_STAGES + simd::int32_4(stages + 0.5f);
+
+        // Lanes past the last channel follow the first lane, so they don't break up a shared route
+        const int activeLanes = std::min(4, channels - c);
+        const HCVRouter8::Route* routes[4];
+        for (int lane = 0; lane < 4; lane++)
+        {
+            const int index = routeIndices[lane < activeLanes ? lane : 0];
+            const int channel = c + (lane < activeLanes ? lane : 0);
+            routes[lane] = routingMode == RANDOM_MODE ? &randomRoutes[channel][index] : &HCVRouter8::getRotation(index);
+        }
+
+        for (int i = 0; i < HCVRouter8::NUM_STAGES; i++)
+        {
+            ins[i] = inputs[IN1_INPUT + i].getPolyVoltageSimd<simd::float_4>(c);
+        }
 
-        rotation = clampInt(rotation);
-        stages = clampInt(stages) + 1;
+        HCVRouter8::process(ins, outs, routes);
 
-        for(int i = 0; i < 8; i++)
+        for (int i = 0; i < HCVRouter8::NUM_STAGES; i++)
         {
-            const int input = (stages - rotation + i) % stages;
-            outputs[i].setVoltage(inputs[input].getPolyVoltage(c), c);
+            outputs[OUT1_OUTPUT + i].setVoltageSimd(outs[i], c);
         }
     }
 
@@ -123,7 +259,22 @@ void Rotator::process(const ProcessArgs &args)
 }
 
 
-struct RotatorWidget : HCVModuleWidget { RotatorWidget(Rotator *module); };
+struct RotatorWidget : HCVModuleWidget
+{
+    RotatorWidget(Rotator *module);
+
+    void appendContextMenu(Menu *menu) override
+    {
+        Rotator *rotator = dynamic_cast<Rotator*>(module);
+        assert(rotator);
+
+        menu->addChild(new MenuSeparator());
+        menu->addChild(createIndexSubmenuItem("Routing Mode", {"Rotate", "Random Permutation"},
+            [=]() { return size_t(rotator->routingMode); },
+            [=](size_t index) { rotator->routingMode = int(index); rotator->wakeUp(); }));
+        menu->addChild(createMenuItem("New Random Permutations", "", [=]() { rotator->permutationsRequested = true; }));
+    }
+};
 
 RotatorWidget::RotatorWidget(Rotator *module)
 {
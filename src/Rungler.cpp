@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVGateLogic.h"
 #include "DSP/HCVShiftRegister.h"
 
 struct Rungler : HCVModule
@@ -75,17 +76,31 @@ struct Rungler : HCVModule
 
     void process(const ProcessArgs &args) override;
 
-    // Arrays for polyphonic support
-    HCVRungler rungler[16];
-    dsp::SchmittTrigger clockTrigger[16];
-    float runglerOut[16] = {};
+    // All 16 channels live in one bit-packed register bank
+    HCVRunglerBank runglers;
+    HCVSchmittBank clockTrigger;
+
+    // Set from the menu and patch load, applied to the register bank at the top of process()
+    int pendingLength = 8;
+    int pendingTaps[3] = {5, 6, 7};
+
+    //also moves the DAC taps to the last three stages, like HCVRunglerBank::setLength()
+    void setRegisterLength(int _length)
+    {
+        pendingLength = clamp(_length, HCVRunglerBank::MIN_LENGTH, HCVRunglerBank::MAX_LENGTH);
+        setDACTaps(pendingLength - 3, pendingLength - 2, pendingLength - 1);
+    }
+
+    void setDACTaps(int _low, int _mid, int _high)
+    {
+        const int taps[3] = {_low, _mid, _high};
+        for (int i = 0; i < 3; i++) pendingTaps[i] = clamp(taps[i], 0, pendingLength - 1);
+    }
 
     void onReset() override
     {
-        for (int c = 0; c < 16; c++)
-        {
-            rungler[c].emptyRegister();
-        }
+        runglers.emptyRegister();
+        setRegisterLength(8);
     }
 
     void onRandomize() override
@@ -93,6 +108,35 @@ struct Rungler : HCVModule
 
 	}
 
+    json_t *dataToJson() override
+    {
+		json_t *rootJ = json_object();
+        json_object_set_new(rootJ, "registerLength", json_integer(pendingLength));
+
+        json_t *tapsJ = json_array();
+        for (int i = 0; i < 3; i++)
+        {
+            json_array_append_new(tapsJ, json_integer(pendingTaps[i]));
+        }
+        json_object_set_new(rootJ, "taps", tapsJ);
+
+		return rootJ;
+	}
+
+    void dataFromJson(json_t *rootJ) override
+    {
+		json_t *lengthJ = json_object_get(rootJ, "registerLength");
+		if (lengthJ) setRegisterLength(json_integer_value(lengthJ));
+
+        json_t *tapsJ = json_object_get(rootJ, "taps");
+        if (tapsJ && json_array_size(tapsJ) == 3)
+        {
+            setDACTaps(json_integer_value(json_array_get(tapsJ, 0)),
+                    json_integer_value(json_array_get(tapsJ, 1)),
+                    json_integer_value(json_array_get(tapsJ, 2)));
+        }
+	}
+
 	// For more advanced Module features, read Rack's engine.hpp header file
 	// - dataToJson, dataFromJson: serialization of internal data
 	// - onSampleRateChange: event triggered by a change of sample rate
@@ -104,53 +148,103 @@ void Rungler::process(const ProcessArgs &args)
     // Determine the number of channels based on connected inputs
     int channels = setupPolyphonyForAllOutputs();
 
+    if(pendingLength != runglers.getLength()) runglers.setLength(pendingLength);
+    if(pendingTaps[0] != runglers.getTap(0) || pendingTaps[1] != runglers.getTap(1) || pendingTaps[2] != runglers.getTap(2))
+    {
+        runglers.setTaps(pendingTaps[0], pendingTaps[1], pendingTaps[2]);
+    }
+
     // Global mode settings (front-panel switches)
     const bool writeMode = (params[WRITE_PARAM].getValue() > 0.0f);
     const bool xorMode = (params[XOR_PARAM].getValue() > 0.0f);
 
-    // Process each channel
-    for (int c = 0; c < channels; c++)
+    const uint32_t clocks = clockTrigger.process(inputs[CLOCK_INPUT], channels);
+
+    if (clocks)
     {
-        if (clockTrigger[c].process(inputs[CLOCK_INPUT].getPolyVoltage(c)))
+        uint32_t data = 0;
+        if (writeMode)
         {
-            rungler[c].enableXORFeedback(xorMode);
-
-            if(!writeMode)
-            {
-                rungler[c].advanceRegisterFrozen();
-            }
-            else
+            for (int c = 0; c < channels; c += 4)
             {
-                double compare = params[COMPARE_PARAM].getValue() + (params[COMPARE_DEPTH_PARAM].getValue() * inputs[COMPARE_INPUT].getPolyVoltage(c));
-                compare = clamp(compare, -5.0f, 5.0f);
+                simd::float_4 compare = params[COMPARE_PARAM].getValue() + (params[COMPARE_DEPTH_PARAM].getValue() * inputs[COMPARE_INPUT].getPolyVoltageSimd<simd::float_4>(c));
+                compare = simd::clamp(compare, -5.0f, 5.0f);
 
-                rungler[c].advanceRegister(inputs[DATA_INPUT].getPolyVoltage(c) > compare);
+                data |= uint32_t(simd::movemask(inputs[DATA_INPUT].getPolyVoltageSimd<simd::float_4>(c) > compare)) << c;
             }
-
-            runglerOut[c] = rungler[c].getRunglerOut();
         }
 
-        double scale = params[SCALE_PARAM].getValue() + (params[SCALE_DEPTH_PARAM].getValue() * inputs[SCALE_INPUT].getPolyVoltage(c));
-        scale = clamp(scale, -5.0f, 5.0f);
+        runglers.enableXORFeedback(xorMode);
+        runglers.advance(clocks, data, !writeMode);
+    }
 
-        outputs[SEQ_OUTPUT].setVoltage(runglerOut[c] * scale, c);
+    const bool sequenceConnected = isOutputConnected(SEQ_OUTPUT);
+    for (int c = 0; c < channels; c += 4)
+    {
+        if(sequenceConnected)
+        {
+            simd::float_4 scale = params[SCALE_PARAM].getValue() + (params[SCALE_DEPTH_PARAM].getValue() * inputs[SCALE_INPUT].getPolyVoltageSimd<simd::float_4>(c));
+            scale = simd::clamp(scale, -5.0f, 5.0f);
+
+            outputs[SEQ_OUTPUT].setVoltageSimd(runglers.getRunglerOut(c) * scale, c);
+        }
 
-        // Set individual stage outputs for each channel
+        // The first 8 stages of each channel
         for(int i = 0; i < 8; i++)
         {
-            outputs[OUT1_OUTPUT + i].setVoltage(rungler[c].dataRegister[i] ? 5.0f : 0.0f, c);
+            if(isOutputConnected(OUT1_OUTPUT + i)) outputs[OUT1_OUTPUT + i].setVoltageSimd(runglers.getStageGates(c, i), c);
         }
     }
 
-    // Lights show the state of channel 0
+    // Lights show the state of channel 0, unpatched stages stay dark
     for(int i = 0; i < 8; i++)
     {
-        lights[OUT1_LIGHT + i].setSmoothBrightness(outputs[OUT1_OUTPUT + i].getVoltage(0) * 0.2f, args.sampleTime);
+        const float stage = isOutputConnected(OUT1_OUTPUT + i) ? outputs[OUT1_OUTPUT + i].getVoltage(0) : 0.0f;
+        lights[OUT1_LIGHT + i].setSmoothBrightness(stage * 0.2f, args.sampleTime);
     }
 }
 
 
-struct RunglerWidget : HCVModuleWidget { RunglerWidget(Rungler *module); };
+struct RunglerWidget : HCVModuleWidget
+{
+    RunglerWidget(Rungler *module);
+
+    void appendContextMenu(Menu *menu) override
+    {
+        Rungler *rungler = dynamic_cast<Rungler*>(module);
+        assert(rungler);
+
+        std::vector<std::string> lengthLabels;
+        for (int i = HCVRunglerBank::MIN_LENGTH; i <= HCVRunglerBank::MAX_LENGTH; i++)
+        {
+            lengthLabels.push_back(std::to_string(i) + " stages");
+        }
+
+        menu->addChild(new MenuSeparator());
+        menu->addChild(createIndexSubmenuItem("Register Length", lengthLabels,
+            [=]() { return size_t(rungler->pendingLength - HCVRunglerBank::MIN_LENGTH); },
+            [=](size_t index) { rungler->setRegisterLength(int(index) + HCVRunglerBank::MIN_LENGTH); }));
+
+        std::vector<std::string> stageLabels;
+        for (int i = 0; i < rungler->pendingLength; i++)
+        {
+            stageLabels.push_back("Stage " + std::to_string(i + 1));
+        }
+
+        const std::string tapNames[3] = {"DAC Tap 1 (LSB)", "DAC Tap 2", "DAC Tap 3 (MSB)"};
+        for (int tap = 0; tap < 3; tap++)
+        {
+            menu->addChild(createIndexSubmenuItem(tapNames[tap], stageLabels,
+                [=]() { return size_t(rungler->pendingTaps[tap]); },
+                [=](size_t index)
+                {
+                    int taps[3] = {rungler->pendingTaps[0], rungler->pendingTaps[1], rungler->pendingTaps[2]};
+                    taps[tap] = int(index);
+                    rungler->setDACTaps(taps[0], taps[1], taps[2]);
+                }));
+        }
+    }
+};
 
 RunglerWidget::RunglerWidget(Rungler *module)
 {
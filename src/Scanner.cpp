@@ -67,7 +67,12 @@ struct Scanner : HCVModule
 		NUM_LIGHTS
 	};
     
-    HCVScanner scanners[16];
+    HCVScanner scanners[4];
+
+    //8 stages keeps the original knob range, 16 scans each input twice
+    int maxStages = 8;
+
+    simd::float_4 stageIns[HCVScanner::MAX_VECTORS], stageOuts[HCVScanner::MAX_VECTORS], stageMults[HCVScanner::MAX_VECTORS];
 
 	Scanner()
 	{
@@ -78,6 +83,7 @@ struct Scanner : HCVModule
         configParam(Scanner::SLOPE_PARAM, 0, 5.0, 0.0, "Slope");
         configSwitch(Scanner::OFFSET_PARAM, 0.0, 1.0, 0.0, "Voltage Offset", {"None", "+5V"});
         configParam(Scanner::MIXSCALE_PARAM, 0.0, 1.0, 0.125, "Mix Scale");
+        enableIdleDetection();
 	}
 
     void process(const ProcessArgs &args) override;
@@ -89,10 +95,24 @@ struct Scanner : HCVModule
         return _in;
     }
 
-    float triShape(float _in)
+    void onReset() override
+    {
+        maxStages = 8;
+        wakeUp();
+    }
+
+    json_t *dataToJson() override
+    {
+        json_t *rootJ = json_object();
+        json_object_set_new(rootJ, "maxStages", json_integer(maxStages));
+        return rootJ;
+    }
+
+    void dataFromJson(json_t *rootJ) override
     {
-        _in = _in - round(_in);
-        return std::abs(_in + _in);
+        json_t *maxStagesJ = json_object_get(rootJ, "maxStages");
+        if (maxStagesJ) maxStages = json_integer_value(maxStagesJ) == 16 ? 16 : 8;
+        wakeUp();
     }
 
 	// For more advanced Module features, read Rack's engine.hpp header file
@@ -104,6 +124,8 @@ struct Scanner : HCVModule
 
 void Scanner::process(const ProcessArgs &args)
 {
+    if(isIdle(args)) return;
+
     const float mixScale = params[MIXSCALE_PARAM].getValue();
     const float stagesKnob = params[STAGES_PARAM].getValue();
     const float widthKnob = params[WIDTH_PARAM].getValue();
@@ -113,61 +135,105 @@ void Scanner::process(const ProcessArgs &args)
 
     const int numChannels = setupPolyphonyForAllOutputs();
 
-    for(int channel = 0; channel < numChannels; channel++)
+    //stages past the eighth read the inputs again, and each output jack carries both of its stages
+    const int numVectors = maxStages/4;
+    const float stagesRange = (maxStages - HCVScanner::MIN_STAGES)/6.0f;
+
+    bool inputConnected[8];
+    for(int i = 0; i < 8; i++)
+    {
+        inputConnected[i] = inputs[IN1_INPUT + i].isConnected();
+    }
+
+    for(int c = 0; c < numChannels; c += 4)
     {
-        float allInValue = offsetValue;
-        if(inputs[ALLIN_INPUT].isConnected()) allInValue = inputs[ALLIN_INPUT].getPolyVoltage(channel);
+        HCVScanner& scanner = scanners[c/4];
 
+        simd::float_4 allIns = offsetValue;
+        if(inputs[ALLIN_INPUT].isConnected()) allIns = inputs[ALLIN_INPUT].getPolyVoltageSimd<simd::float_4>(c);
+
+        simd::float_4 blockIns[8];
         for(int i = 0; i < 8; i++)
         {
-            if(!inputs[IN1_INPUT + i].isConnected()) scanners[channel].setInput(i, allInValue);
-            else scanners[channel].setInput(i, inputs[IN1_INPUT + i].getPolyVoltage(channel)); 
+            blockIns[i] = inputConnected[i] ? inputs[IN1_INPUT + i].getPolyVoltageSimd<simd::float_4>(c) : allIns;
         }
 
-        int stages = round(stagesKnob + inputs[STAGES_INPUT].getPolyVoltage(channel));
-        stages = clampInt(stages, 0, 6) + 2;
-        scanners[channel].setNumStages(stages);
-
-        float widthControl =  widthKnob + inputs[WIDTH_INPUT].getPolyVoltage(channel);
-        widthControl = clamp(widthControl, 0.0f, 5.0f) * 0.2f;
-        scanners[channel].setWidthParameter(widthControl);
-
-        float scanControl = scanKnob + inputs[SCAN_INPUT].getPolyVoltage(channel);
-        scanControl = clamp(scanControl, 0.0f, 5.0f) * 0.2f;
-        scanners[channel].setScanParameter(scanControl);
-
-        float slopeControl = slopeKnob + inputs[SLOPE_INPUT].getPolyVoltage(channel);
-        slopeControl = clamp(slopeControl, 0.0f, 5.0f) * 0.2f;
-        scanners[channel].setSlopeParameter(slopeControl);
-
-        float mix = 0.0f;
+        const simd::float_4 stageControls = stagesKnob + inputs[STAGES_INPUT].getPolyVoltageSimd<simd::float_4>(c);
+        int stages[4];
+        for(int lane = 0; lane < 4; lane++)
+        {
+            stages[lane] = clampInt(round(stageControls[lane]), 0, 6);
+            if(maxStages > 8) stages[lane] = round(clamp(stageControls[lane], 0.0f, 6.0f) * stagesRange);
+            stages[lane] += HCVScanner::MIN_STAGES;
+        }
 
-        scanners[channel].process();
+        const simd::float_4 widthControls = simd::clamp(widthKnob + inputs[WIDTH_INPUT].getPolyVoltageSimd<simd::float_4>(c), 0.0f, 5.0f) * 0.2f;
+        const simd::float_4 scanControls = simd::clamp(scanKnob + inputs[SCAN_INPUT].getPolyVoltageSimd<simd::float_4>(c), 0.0f, 5.0f) * 0.2f;
+        const simd::float_4 slopeControls = simd::clamp(slopeKnob + inputs[SLOPE_INPUT].getPolyVoltageSimd<simd::float_4>(c), 0.0f, 5.0f) * 0.2f;
+        scanner.setParameters(stages, scanControls, widthControls, slopeControls);
 
-        for(int i = 0; i < 8; i++)
+        const int activeLanes = std::min(4, numChannels - c);
+        for(int lane = 0; lane < activeLanes; lane++)
         {
-            const float channelOut = scanners[channel].getOutput(i);
-            outputs[i].setVoltage(channelOut, channel);
-
-            mix = mix + channelOut;
+            const int channel = c + lane;
+
+            for(int i = 0; i < 4*numVectors; i++)
+            {
+                stageIns[i/4][i % 4] = blockIns[i % 8][lane];
+            }
+
+            scanner.process(lane, numVectors, stageIns, stageOuts, stageMults);
+
+            simd::float_4 mix = 0.0f;
+            for(int i = 0; i < numVectors; i++)
+            {
+                mix += stageOuts[i];
+            }
+
+            for(int i = 0; i < 8; i++)
+            {
+                float channelOut = stageOuts[i/4][i % 4];
+                if(numVectors > 2) channelOut += stageOuts[i/4 + 2][i % 4];
+                outputs[i].setVoltage(channelOut, channel);
+            }
+
+            outputs[MIX_OUTPUT].setVoltage((mix[0] + mix[1] + mix[2] + mix[3]) * mixScale, channel);
+
+            if(channel == 0)
+            {
+                //lights
+                for(int i = 0; i < 8; i ++)
+                {
+                    float mult = stageMults[i/4][i % 4];
+                    if(numVectors > 2) mult = fmaxf(mult, stageMults[i/4 + 2][i % 4]);
+
+                    const float channelOut = outputs[i].getVoltage(0);
+                    lights[IN1_LIGHT + i].setSmoothBrightness(fmaxf(0.0, mult), args.sampleTime);
+
+                    lights[OUT1_POS_LIGHT + 2*i].setSmoothBrightness(fmaxf(0.0f, channelOut * 0.2f), args.sampleTime);
+                    lights[OUT1_NEG_LIGHT + 2*i].setSmoothBrightness(fmaxf(0.0f, channelOut * -0.2f), args.sampleTime);
+                }
+            }
         }
-
-        outputs[MIX_OUTPUT].setVoltage(mix * mixScale, channel);
     }
+}
 
-    //lights
-    for(int i = 0; i < 8; i ++)
-    {
-        const float channelOut = scanners[0].getOutput(i);
-        lights[IN1_LIGHT + i].setSmoothBrightness(fmaxf(0.0, scanners[0].getMult(i)), args.sampleTime);
 
-        lights[OUT1_POS_LIGHT + 2*i].setSmoothBrightness(fmaxf(0.0f, channelOut * 0.2f), args.sampleTime);
-        lights[OUT1_NEG_LIGHT + 2*i].setSmoothBrightness(fmaxf(0.0f, channelOut * -0.2f), args.sampleTime);
-    }
-}
+struct ScannerWidget : HCVModuleWidget
+{
+    ScannerWidget(Scanner *module);
 
+    void appendContextMenu(Menu *menu) override
+    {
+        Scanner *scanner = dynamic_cast<Scanner*>(module);
+        assert(scanner);
 
-struct ScannerWidget : HCVModuleWidget { ScannerWidget(Scanner *module); };
+        menu->addChild(new MenuSeparator());
+        menu->addChild(createIndexSubmenuItem("Maximum Stages", {"8", "16"},
+            [=]() { return size_t(scanner->maxStages > 8 ? 1 : 0); },
+            [=](size_t index) { scanner->maxStages = index ? 16 : 8; scanner->wakeUp(); }));
+    }
+};
 
 ScannerWidget::ScannerWidget(Scanner *module)
 {
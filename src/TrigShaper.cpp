@@ -1,5 +1,8 @@
 #include "HetrickCV.hpp"                                   
 #include "DSP/HCVDCFilter.h"
+#include "DSP/HCVGateLogic.h"
+#include "DSP/HCVTrigShaper.h"
+#include "DSP/HCVOversampler.h"
 
 struct TrigShaper : HCVModule
 {
@@ -57,7 +60,27 @@ struct TrigShaper : HCVModule
 
 	void process(const ProcessArgs &args) override;
 
-	HCVDCFilter dcFilters[16];
+	HCVDCFilterT<simd::float_4> dcFilters[4];
+	HCVOversampler4 oversamplers[4];
+	int oversampling = 0;
+
+	void onReset() override
+	{
+		oversampling = 0;
+	}
+
+	json_t *dataToJson() override
+	{
+		json_t *rootJ = json_object();
+		json_object_set_new(rootJ, "oversampling", json_integer(oversampling));
+		return rootJ;
+	}
+
+	void dataFromJson(json_t *rootJ) override
+	{
+		json_t *oversamplingJ = json_object_get(rootJ, "oversampling");
+		if (oversamplingJ) oversampling = clamp(int(json_integer_value(oversamplingJ)), 0, HCVOversampler4::MAX_STAGES);
+	}
 
 	float upscale = 5.0f;
 	float downscale = 0.2f;
@@ -87,93 +110,54 @@ void TrigShaper::process(const ProcessArgs &args)
 	int numChannels = getMaxInputPolyphony();
 	outputs[MAIN_OUTPUT].setChannels(numChannels);
 
-	for (int chan = 0; chan < numChannels; chan++)
+	for (int c = 0; c < numChannels; c += 4)
 	{
-        float input = inputs[MAIN_INPUT].getPolyVoltage(chan) * inputScale;
-        input = clamp(input, -PI, PI);
-        float hardClipped = clamp(input, -1.0f, 1.0f);
+        const simd::float_4 input = inputs[MAIN_INPUT].getPolyVoltageSimd<simd::float_4>(c) * inputScale;
 
-        float output = 0.0f;
+        const simd::float_4 functions = simd::clamp(simd::trunc(functionKnob + inputs[FUNCTION_INPUT].getPolyVoltageSimd<simd::float_4>(c) * 0.4f), 0.0f, 2.0f);
+        const simd::float_4 modes = simd::clamp(simd::trunc(modeKnob + inputs[MODE_INPUT].getPolyVoltageSimd<simd::float_4>(c) * 0.4f), 0.0f, 2.0f);
+        simd::float_4 kernels = functions * float(HCVTrigShaper::NUM_MODES) + modes;
 
-        int function = functionKnob + inputs[FUNCTION_INPUT].getPolyVoltage(chan) * 0.4f;
-        int mode = modeKnob + inputs[MODE_INPUT].getPolyVoltage(chan) * 0.4f;
+        // Lanes past the last channel follow the first lane, so they never add a kernel
+        const simd::float_4 activeLanes = HCVGateLogic::bitsToLanes(HCVGateLogic::blockMask(c, numChannels));
+        kernels = simd::ifelse(activeLanes, kernels, kernels[0]);
 
-        function = clamp(function, 0, 2);
-        mode = clamp(mode, 0, 2);
+        const int firstKernel = int(kernels[0]);
+        const bool singleKernel = simd::movemask(kernels == float(firstKernel)) == 0xF;
 
-        switch (function)
+        oversamplers[c/4].setStages(oversampling);
+        simd::float_4 output = oversamplers[c/4].process(input, [&](simd::float_4 _x)
         {
-        case 0: //SINE
-            switch (mode)
-            {
-            case 0:
-                output = sin(input);
-                break;
-
-            case 1:
-                output = sinh(input);
-                break;
-
-            case 2:
-                output = asin(hardClipped);
-                break;
-            
-            default:
-                break;
-            }
-            break;
+            _x = simd::clamp(_x, -PI, PI);
+            const simd::float_4 hardClipped = simd::clamp(_x, -1.0f, 1.0f);
 
-        case 1: //COSINE
-            switch (mode)
+            simd::float_4 shaped;
+            if (singleKernel)
             {
-            case 0:
-                output = cos(input);
-                break;
-
-            case 1:
-                output = cosh(input) - 2.0f;
-                break;
-
-            case 2:
-                output = acos(hardClipped);
-                break;
-            
-            default:
-                break;
+                shaped = HCVTrigShaper::process(firstKernel, _x, hardClipped);
             }
-            break;
-
-        case 2: //TANGENT
-            switch (mode)
+            else
             {
-            case 0:
-                output = tan(input);
-                break;
-
-            case 1:
-                output = tanh(input);
-                break;
-
-            case 2:
-                output = atan(input);
-                break;
-            
-            default:
-                break;
+                // Lanes disagree, so each kernel in use is run once and masked in
+                shaped = 0.0f;
+                for (int kernel = 0; kernel < HCVTrigShaper::NUM_KERNELS; kernel++)
+                {
+                    const simd::float_4 lanes = kernels == float(kernel);
+                    if (simd::movemask(lanes)) shaped = simd::ifelse(lanes, HCVTrigShaper::process(kernel, _x, hardClipped), shaped);
+                }
             }
-            break;
-        
-        default:
-            output = input;
-            break;
-        }
-
-        if(!std::isnormal(output)) output = 0.0f;
-
-        output = clamp(output, -1.0f, 1.0f);
-        dcFilters[chan].setEnabled(filterDC);
-        output = dcFilters[chan](output);
-        outputs[MAIN_OUTPUT].setVoltage(output * upscale, chan);
+
+            // Same as zeroing everything that fails std::isnormal()
+            const simd::float_4 magnitude = simd::fabs(shaped);
+            shaped = simd::ifelse((magnitude >= std::numeric_limits<float>::min()) & (magnitude <= std::numeric_limits<float>::max()), shaped, 0.0f);
+            return simd::clamp(shaped, -1.0f, 1.0f);
+        });
+
+        // Unused lanes rest at zero so their DC filters are settled when they're used
+        output = simd::ifelse(activeLanes, output, 0.0f);
+        dcFilters[c/4].setEnabled(filterDC);
+        output = dcFilters[c/4](output);
+        outputs[MAIN_OUTPUT].setVoltageSimd(output * upscale, c);
 	}
 
     int functionLight = functionKnob + inputs[FUNCTION_INPUT].getVoltage() * 0.4f;
@@ -193,7 +177,19 @@ void TrigShaper::process(const ProcessArgs &args)
 }
 
 
-struct TrigShaperWidget : HCVModuleWidget { TrigShaperWidget(TrigShaper *module); };
+struct TrigShaperWidget : HCVModuleWidget
+{
+	TrigShaperWidget(TrigShaper *module);
+
+	void appendContextMenu(Menu *menu) override
+	{
+		TrigShaper *trigShaper = dynamic_cast<TrigShaper*>(module);
+		assert(trigShaper);
+
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createIndexPtrSubmenuItem("Oversampling", HCVOversampler4::getLabels(), &trigShaper->oversampling));
+	}
+};
 
 TrigShaperWidget::TrigShaperWidget(TrigShaper *module)
 {
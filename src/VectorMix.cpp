@@ -1,5 +1,7 @@
 #include "HetrickCV.hpp"
 #include "dsp/digital.hpp"
+#include "DSP/HCVSlewLimiter.h"
+#include "DSP/HCVVectorMixer.h"
                      
 
 struct VectorMix : HCVModule
@@ -98,24 +100,32 @@ struct VectorMix : HCVModule
         configOutput(OUTD_OUTPUT, "D");
 	}
 
-    simd::float_4   insA[4] = {0.0f, 0.0f, 0.0f, 0.0f}, 
-                    insB[4] = {0.0f, 0.0f, 0.0f, 0.0f}, 
-                    insC[4] = {0.0f, 0.0f, 0.0f, 0.0f}, 
-                    insD[4] = {0.0f, 0.0f, 0.0f, 0.0f},
-                    insAll[4] = {0.0f, 0.0f, 0.0f, 0.0f}, 
-                    insX[4] = {0.0f, 0.0f, 0.0f, 0.0f}, 
-                    insY[4] = {0.0f, 0.0f, 0.0f, 0.0f},
-                    outMultsA[4] = {0.0f, 0.0f, 0.0f, 0.0f}, 
-                    outMultsB[4] = {0.0f, 0.0f, 0.0f, 0.0f}, 
-                    outMultsC[4] = {0.0f, 0.0f, 0.0f, 0.0f}, 
-                    outMultsD[4] = {0.0f, 0.0f, 0.0f, 0.0f},
-                    abMix[4] = {0.0f, 0.0f, 0.0f, 0.0f}, 
-                    cdMix[4] = {0.0f, 0.0f, 0.0f, 0.0f},
-                    outA[4] = {0.0f, 0.0f, 0.0f, 0.0f},
-                    outB[4] = {0.0f, 0.0f, 0.0f, 0.0f},
-                    outC[4] = {0.0f, 0.0f, 0.0f, 0.0f},
-                    outD[4] = {0.0f, 0.0f, 0.0f, 0.0f}, 
-                    outMix[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    //knob moves ramp per sample instead of stepping at the control rate
+    HCVSlewLimiter<simd::float_4> gainSlew, positionSlew;
+
+    int layout = HCVVectorMixer::SQUARE_LAYOUT;
+
+    //channel 0 for the lights
+    simd::float_4 lightWeights[HCVVectorMixer::NUM_CORNERS] = {};
+    simd::float_4 lightOuts[HCVVectorMixer::NUM_CORNERS] = {};
+
+    void onReset() override
+    {
+        layout = HCVVectorMixer::SQUARE_LAYOUT;
+    }
+
+    json_t *dataToJson() override
+    {
+        json_t *rootJ = json_object();
+        json_object_set_new(rootJ, "layout", json_integer(layout));
+        return rootJ;
+    }
+
+    void dataFromJson(json_t *rootJ) override
+    {
+        json_t *layoutJ = json_object_get(rootJ, "layout");
+        if (layoutJ) layout = clamp(int(json_integer_value(layoutJ)), 0, HCVVectorMixer::NUM_LAYOUTS - 1);
+    }
 
 	void process(const ProcessArgs &args) override;
 
@@ -131,20 +141,28 @@ void VectorMix::process(const ProcessArgs &args)
 
     int channels = getMaxInputPolyphony();
 
-    //TODO: Interpolation
-    const float gainA = params[GAINA_PARAM].getValue();
-    const float gainB = params[GAINB_PARAM].getValue();
-    const float gainC = params[GAINC_PARAM].getValue();
-    const float gainD = params[GAIND_PARAM].getValue();
+    const simd::float_4 gains = gainSlew.process(simd::float_4(
+        params[GAINA_PARAM].getValue(), params[GAINB_PARAM].getValue(), params[GAINC_PARAM].getValue(), params[GAIND_PARAM].getValue()));
 
     const float offsetValue = params[OFFSET_PARAM].getValue() > 0.0f ? 5.0f : 0.0f;
     lights[OFFSET_LIGHT].setBrightness(offsetValue);
 
-    const float xKnob = params[X_PARAM].getValue();
-    const float xScale = params[XCV_PARAM].getValue() * 0.2;
+    const simd::float_4 positions = positionSlew.process(simd::float_4(
+        params[X_PARAM].getValue(), params[XCV_PARAM].getValue() * 0.2f, params[Y_PARAM].getValue(), params[YCV_PARAM].getValue() * 0.2f));
+    const float xKnob = positions[0];
+    const float xScale = positions[1];
+    const float yKnob = positions[2];
+    const float yScale = positions[3];
 
-    const float yKnob = params[Y_PARAM].getValue();
-    const float yScale = params[YCV_PARAM].getValue() * 0.2;
+    const int cornerInputs[HCVVectorMixer::NUM_CORNERS] = {INA_INPUT, INB_INPUT, INC_INPUT, IND_INPUT};
+    const int cornerOutputs[HCVVectorMixer::NUM_CORNERS] = {OUTA_OUTPUT, OUTB_OUTPUT, OUTC_OUTPUT, OUTD_OUTPUT};
+
+    bool cornerConnected[HCVVectorMixer::NUM_CORNERS];
+    for (int i = 0; i < HCVVectorMixer::NUM_CORNERS; i++)
+    {
+        cornerConnected[i] = outputs[cornerOutputs[i]].isConnected();
+    }
+    const bool mixConnected = outputs[OUTMAIN_OUTPUT].isConnected();
 
     outputs[OUTMAIN_OUTPUT].setChannels(channels);
     outputs[OUTA_OUTPUT].setChannels(channels);
@@ -155,74 +173,66 @@ void VectorMix::process(const ProcessArgs &args)
 
 	for (int c = 0; c < channels; c += 4) 
 	{
-        const int vectorIndex = c/4;
+        simd::float_4 x = simd::float_4::load(inputs[INX_INPUT].getVoltages(c));
+		x = (x * xScale) + xKnob;
+        x = clamp(x, 0.0f, 1.0f);
 
-        insX[vectorIndex] = simd::float_4::load(inputs[INX_INPUT].getVoltages(c));
-		insX[vectorIndex] = (insX[vectorIndex] * xScale) + xKnob;
-        insX[vectorIndex] = clamp(insX[vectorIndex], 0.0f, 1.0f);
-
-        insY[vectorIndex] = simd::float_4::load(inputs[INY_INPUT].getVoltages(c));
-		insY[vectorIndex] = (insY[vectorIndex] * yScale) + yKnob;
-        insY[vectorIndex] = clamp(insY[vectorIndex], 0.0f, 1.0f);
+        simd::float_4 y = simd::float_4::load(inputs[INY_INPUT].getVoltages(c));
+		y = (y * yScale) + yKnob;
+        y = clamp(y, 0.0f, 1.0f);
 
+        simd::float_4 insAll = offsetValue;
         if(inputs[ALL_INPUT].isConnected())
         {
-            insAll[vectorIndex] = simd::float_4::load(inputs[ALL_INPUT].getVoltages(c));
+            insAll = simd::float_4::load(inputs[ALL_INPUT].getVoltages(c));
         }
-        else
+
+        simd::float_4 weights[HCVVectorMixer::NUM_CORNERS];
+        HCVVectorMixer::getWeights(layout, x, y, weights);
+
+        simd::float_4 outMix = 0.0f;
+        for (int i = 0; i < HCVVectorMixer::NUM_CORNERS; i++)
         {
-            insAll[vectorIndex] = {offsetValue, offsetValue, offsetValue, offsetValue};
+            simd::float_4 in = inputs[cornerInputs[i]].isConnected() ? simd::float_4::load(inputs[cornerInputs[i]].getVoltages(c)) : insAll;
+            in *= gains[i];
+
+            simd::float_4 out = in * weights[i];
+            outMix += out;
+
+            if (cornerConnected[i]) out.store(outputs[cornerOutputs[i]].getVoltages(c));
+            if (c == 0)
+            {
+                lightWeights[i] = weights[i];
+                lightOuts[i] = out;
+            }
         }
 
-		insA[vectorIndex] = inputs[INA_INPUT].isConnected() ? simd::float_4::load(inputs[INA_INPUT].getVoltages(c)) : insAll[vectorIndex];
-        insB[vectorIndex] = inputs[INB_INPUT].isConnected() ? simd::float_4::load(inputs[INB_INPUT].getVoltages(c)) : insAll[vectorIndex];
-        insC[vectorIndex] = inputs[INC_INPUT].isConnected() ? simd::float_4::load(inputs[INC_INPUT].getVoltages(c)) : insAll[vectorIndex];
-        insD[vectorIndex] = inputs[IND_INPUT].isConnected() ? simd::float_4::load(inputs[IND_INPUT].getVoltages(c)) : insAll[vectorIndex];
-
-        insA[vectorIndex] *= gainA;
-        insB[vectorIndex] *= gainB;
-        insC[vectorIndex] *= gainC;
-        insD[vectorIndex] *= gainD;
-
-        outMultsA[vectorIndex] = (1.0f - insX[vectorIndex]) * (1.0f - insY[vectorIndex]);
-        outMultsB[vectorIndex] = insX[vectorIndex] * (1.0f - insY[vectorIndex]);
-        outMultsC[vectorIndex] = (1.0f - insX[vectorIndex]) * insY[vectorIndex];
-        outMultsD[vectorIndex] = insX[vectorIndex] * insY[vectorIndex];
-
-        outA[vectorIndex] = insA[vectorIndex] * outMultsA[vectorIndex];
-        outB[vectorIndex] = insB[vectorIndex] * outMultsB[vectorIndex];
-        outC[vectorIndex] = insC[vectorIndex] * outMultsC[vectorIndex];
-        outD[vectorIndex] = insD[vectorIndex] * outMultsD[vectorIndex];
-
-        outMix[vectorIndex] = outA[vectorIndex] + outB[vectorIndex] + outC[vectorIndex] + outD[vectorIndex];
-
-        outMix[vectorIndex].store(outputs[OUTMAIN_OUTPUT].getVoltages(c));
-        outA[vectorIndex].store(outputs[OUTA_OUTPUT].getVoltages(c));
-        outB[vectorIndex].store(outputs[OUTB_OUTPUT].getVoltages(c));
-        outC[vectorIndex].store(outputs[OUTC_OUTPUT].getVoltages(c));
-        outD[vectorIndex].store(outputs[OUTD_OUTPUT].getVoltages(c));
+        if (mixConnected) outMix.store(outputs[OUTMAIN_OUTPUT].getVoltages(c));
 	}
 
-    lights[POSA_LIGHT].setBrightness(outMultsA[0][0]);
-    lights[POSB_LIGHT].setBrightness(outMultsB[0][0]);
-    lights[POSC_LIGHT].setBrightness(outMultsC[0][0]);
-    lights[POSD_LIGHT].setBrightness(outMultsD[0][0]);
-
-	lights[OUTA_POS_LIGHT].setBrightness(fmax(0.0f,  outA[0][0]));
-    lights[OUTA_NEG_LIGHT].setBrightness(fmax(0.0f, -outA[0][0]));
+    for (int i = 0; i < HCVVectorMixer::NUM_CORNERS; i++)
+    {
+        lights[POSA_LIGHT + i].setBrightness(lightWeights[i][0]);
 
-    lights[OUTB_POS_LIGHT].setBrightness(fmax(0.0f,  outB[0][0]));
-    lights[OUTB_NEG_LIGHT].setBrightness(fmax(0.0f, -outB[0][0]));
+        lights[OUTA_POS_LIGHT + 2*i].setBrightness(fmax(0.0f,  lightOuts[i][0]));
+        lights[OUTA_NEG_LIGHT + 2*i].setBrightness(fmax(0.0f, -lightOuts[i][0]));
+    }
 
-    lights[OUTC_POS_LIGHT].setBrightness(fmax(0.0f,  outC[0][0]));
-    lights[OUTC_NEG_LIGHT].setBrightness(fmax(0.0f, -outC[0][0]));
+}
 
-    lights[OUTD_POS_LIGHT].setBrightness(fmax(0.0f,  outD[0][0]));
-    lights[OUTD_NEG_LIGHT].setBrightness(fmax(0.0f, -outD[0][0]));
+struct VectorMixWidget : HCVModuleWidget
+{
+    VectorMixWidget(VectorMix *module);
 
-}
+    void appendContextMenu(Menu *menu) override
+    {
+        VectorMix *vectorMix = dynamic_cast<VectorMix*>(module);
+        assert(vectorMix);
 
-struct VectorMixWidget : HCVModuleWidget { VectorMixWidget(VectorMix *module); };
+        menu->addChild(new MenuSeparator());
+        menu->addChild(createIndexPtrSubmenuItem("Vector Layout", HCVVectorMixer::getLabels(), &vectorMix->layout));
+    }
+};
 
 VectorMixWidget::VectorMixWidget(VectorMix *module)
 {
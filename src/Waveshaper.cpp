@@ -1,4 +1,5 @@
 #include "HetrickCV.hpp"
+#include "DSP/HCVOversampler.h"
 
 /*                                                   
                         ┌──────────────┐             
@@ -61,8 +62,50 @@ struct Waveshape : HCVModule
 		return output;
 	}
 
+	//antiderivative of hyperbolicWaveshaper: (a + b)/b * x^2 * h(u) with u = a|x|/b and h(u) = (u - ln(1 + u))/u^2.
+	//Small u uses the series of h, where the closed form cancels.
+	simd::float_4 hyperbolicAntiderivative(simd::float_4 _input, simd::float_4 _shape)
+	{
+		const simd::float_4 shapeB = (1.0f - _shape) / (1.0f + _shape);
+		const simd::float_4 shapeA = (4.0f * _shape) / ((1.0f - _shape) * (1.0f + _shape));
+
+		const simd::float_4 u = shapeA * abs(_input) / shapeB;
+		const simd::float_4 series = 0.5f + u * (-1.0f/3.0f + u * (0.25f + u * (-0.2f + u * (1.0f/6.0f + u * (-1.0f/7.0f + u * 0.125f)))));
+		const simd::float_4 closedForm = (u - fastLog2(1.0f + u) * 0.69314718056f) / (u * u);
+
+		return (shapeA + shapeB) / shapeB * _input * _input * simd::ifelse(abs(u) < 0.1f, series, closedForm);
+	}
+
 	simd::float_4 ins[4] = {0.0f, 0.0f, 0.0f, 0.0f}, shapes[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 
+	HCVOversampler4 oversamplers[4];
+	HCVADAA4 antialiasers[4];
+	int oversampling = 0;
+	bool antialiasing = false;
+
+	void onReset() override
+	{
+		oversampling = 0;
+		antialiasing = false;
+	}
+
+	json_t *dataToJson() override
+	{
+		json_t *rootJ = json_object();
+		json_object_set_new(rootJ, "oversampling", json_integer(oversampling));
+		json_object_set_new(rootJ, "antialiasing", json_boolean(antialiasing));
+		return rootJ;
+	}
+
+	void dataFromJson(json_t *rootJ) override
+	{
+		json_t *oversamplingJ = json_object_get(rootJ, "oversampling");
+		if (oversamplingJ) oversampling = clamp(int(json_integer_value(oversamplingJ)), 0, HCVOversampler4::MAX_STAGES);
+
+		json_t *antialiasingJ = json_object_get(rootJ, "antialiasing");
+		if (antialiasingJ) antialiasing = json_boolean_value(antialiasingJ);
+	}
+
 	float upscale = 5.0f;
 	float downscale = 0.2f;
 };
@@ -99,7 +142,17 @@ void Waveshape::process(const ProcessArgs &args)
 		shapes[vectorIndex] = clamp(shapes[vectorIndex], -5.0f, 5.0f) * 0.2f;
 		shapes[vectorIndex] *= 0.99f;
 
-		ins[vectorIndex] = hyperbolicWaveshaper(ins[vectorIndex], shapes[vectorIndex]);
+		const simd::float_4 shape = shapes[vectorIndex];
+		auto shaper = [&](simd::float_4 _x) { return hyperbolicWaveshaper(_x, shape); };
+		auto antiderivative = [&](simd::float_4 _x) { return hyperbolicAntiderivative(_x, shape); };
+
+		//negative shapes have a pole just past [-1, 1], so filter overshoot is clamped away
+		oversamplers[vectorIndex].setStages(oversampling);
+		ins[vectorIndex] = oversamplers[vectorIndex].process(ins[vectorIndex], [&](simd::float_4 _x)
+		{
+			_x = clamp(_x, -1.0f, 1.0f);
+			return antialiasing ? antialiasers[vectorIndex].process(_x, shaper, antiderivative) : shaper(_x);
+		});
 		ins[vectorIndex] *= upscale;
 
 		ins[vectorIndex].store(outputs[MAIN_OUTPUT].getVoltages(c));
@@ -107,7 +160,20 @@ void Waveshape::process(const ProcessArgs &args)
 }
 
 
-struct WaveshapeWidget : HCVModuleWidget { WaveshapeWidget(Waveshape *module); };
+struct WaveshapeWidget : HCVModuleWidget
+{
+	WaveshapeWidget(Waveshape *module);
+
+	void appendContextMenu(Menu *menu) override
+	{
+		Waveshape *waveshape = dynamic_cast<Waveshape*>(module);
+		assert(waveshape);
+
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createIndexPtrSubmenuItem("Oversampling", HCVOversampler4::getLabels(), &waveshape->oversampling));
+		menu->addChild(createBoolPtrMenuItem("Antiderivative Anti-aliasing", "", &waveshape->antialiasing));
+	}
+};
 
 WaveshapeWidget::WaveshapeWidget(Waveshape *module)
 {
@@ -33,6 +33,7 @@ struct XYToPolar : HCVModule
 	XYToPolar()
 	{
         config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+        enableIdleDetection();
 	}
 
 	void process(const ProcessArgs &args) override;
@@ -51,6 +52,8 @@ struct XYToPolar : HCVModule
 
 void XYToPolar::process(const ProcessArgs &args)
 {
+    if(isIdle(args)) return;
+
     int channels = getMaxInputPolyphony();
     outputs[OUTX_OUTPUT].setChannels(channels);
     outputs[OUTY_OUTPUT].setChannels(channels);